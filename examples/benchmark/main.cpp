@@ -0,0 +1,136 @@
+// Benchmark of the library against the simulated chip, no EEPROM needs to be connected.
+// It runs on the boards with more than 128 KiB of RAM (ESP32, RP2040, SAMD51...), not on AVR.
+// The times are measured on the virtual bus clock of Mem24CSM01Simulator, so they are the bus
+// times of the real chip at the given clock, write cycles included (5 ms each).
+// On a PC it is built and run by the host build, see extras/host/CMakeLists.txt.
+
+#include <Arduino.h>
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Cache.h"
+#include "MIC24CSM01Stream.h"
+#include "MIC24CSM01Simulator.h"
+
+#define BENCH_BLOCK_SIZE 4096 // Bytes moved by the bulk operations
+
+Mem24CSM01Simulator *simulator;
+Mem24CSM01 *memory;
+uint8_t block[BENCH_BLOCK_SIZE];
+
+typedef MEMORYRESULT (*Operation)(uint16_t iteration);
+
+MEMORYRESULT singleByteWrite(uint16_t iteration)
+{
+  return (memory->write(0x1000 + iteration, (uint8_t)iteration));
+}
+
+MEMORYRESULT pageWrite(uint16_t iteration)
+{
+  return (memory->writeBulk(0x2000 + iteration * MAX_MEMORY_PAGE_SIZE, block, MAX_MEMORY_PAGE_SIZE));
+}
+
+MEMORYRESULT bulkWrite(uint16_t iteration)
+{
+  return (memory->writeBulk(0x4000, block, BENCH_BLOCK_SIZE));
+}
+
+MEMORYRESULT unchangedUpdate(uint16_t iteration)
+{
+  return (memory->update(0x4000, block, BENCH_BLOCK_SIZE));
+}
+
+MEMORYRESULT bulkRead(uint16_t iteration)
+{
+  return (memory->read(0x4000, block, BENCH_BLOCK_SIZE));
+}
+
+MEMORYRESULT sequentialShortReads(uint16_t iteration)
+{
+  uint8_t parameter[16];
+  return (memory->read(0x4000 + iteration * sizeof(parameter), parameter, sizeof(parameter)));
+}
+
+MEMORYRESULT randomShortReads(uint16_t iteration)
+{
+  uint8_t parameter[16];
+  return (memory->read(0x4000 + (iteration * 1031UL) % (BENCH_BLOCK_SIZE - sizeof(parameter)), parameter, sizeof(parameter)));
+}
+
+MEMORYRESULT cachedWrites(uint16_t iteration)
+{
+  static Mem24CSM01Cache cache(*memory);
+  for (uint16_t i = 0; i < 256; ++i)
+  {
+    cache.write(0x8000 + (i * 37) % MAX_MEMORY_PAGE_SIZE, (uint8_t)(i + iteration)); // Scattered in one page
+  }
+  return (cache.flush());
+}
+
+MEMORYRESULT streamRead(uint16_t iteration)
+{
+  Mem24CSM01Stream stream(*memory, 0x4000, BENCH_BLOCK_SIZE);
+  while (stream.available())
+  {
+    stream.read();
+  }
+  return (stream.getLastResult());
+}
+
+void run(const char *name, Operation operation, uint16_t iterations, uint32_t bytesPerOperation)
+{
+  memory->waitForWriteCompletion();
+  simulator->resetCounters();
+  uint64_t start = simulator->getElapsedNanos();
+  MEMORYRESULT result = MEMORYRESULT::OK;
+  for (uint16_t i = 0; i < iterations && result == MEMORYRESULT::OK; ++i)
+  {
+    result = operation(i);
+  }
+  memory->waitForWriteCompletion(); // The last write cycle is part of the operation
+  uint64_t elapsed = simulator->getElapsedNanos() - start;
+  Serial.print(name);
+  Serial.print(result == MEMORYRESULT::OK ? "\t" : "\tFAILED ");
+  Serial.print((uint32_t)((uint64_t)bytesPerOperation * iterations * 1000000000ULL / elapsed));
+  Serial.print(" B/s\t");
+  Serial.print((float)simulator->getTransactions() / iterations, 1);
+  Serial.print(" transactions/op\t");
+  Serial.print((float)simulator->getWriteCycles() / iterations, 1);
+  Serial.println(" write cycles/op");
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  while (!Serial)
+  {
+  }
+  simulator = new Mem24CSM01Simulator(false, false); // Wire buffer size of this board
+  memory = new Mem24CSM01(false, false, *simulator);
+  for (size_t i = 0; i < sizeof(block); ++i)
+  {
+    block[i] = (uint8_t)(i * 7);
+  }
+
+  const uint32_t clocks[] = {MEM24CSM01_CLOCK_STANDARD, MEM24CSM01_CLOCK_FAST, MEM24CSM01_CLOCK_FAST_PLUS};
+  for (uint8_t c = 0; c < sizeof(clocks) / sizeof(clocks[0]); ++c)
+  {
+    memory->begin(clocks[c]);
+    Serial.print("\nBus clock ");
+    Serial.print(clocks[c] / 1000);
+    Serial.print(" kHz, Wire buffer ");
+    Serial.print(MEM24CSM01_WIRE_BUFFER_SIZE);
+    Serial.println(" bytes");
+    run("write(byte)", singleByteWrite, 64, 1);
+    run("page write", pageWrite, 16, MAX_MEMORY_PAGE_SIZE);
+    run("writeBulk 4K", bulkWrite, 2, BENCH_BLOCK_SIZE);
+    run("update 4K same", unchangedUpdate, 2, BENCH_BLOCK_SIZE);
+    run("read 4K", bulkRead, 4, BENCH_BLOCK_SIZE);
+    run("read 16 seq", sequentialShortReads, 64, 16);
+    run("read 16 random", randomShortReads, 64, 16);
+    run("cache 256 writes", cachedWrites, 4, 256);
+    run("stream read 4K", streamRead, 4, BENCH_BLOCK_SIZE);
+  }
+}
+
+void loop()
+{
+}
@@ -8,12 +8,14 @@
 // #include <avr8-stub.h> // debug only
 
 Mem24CSM01 memory(false, false);
+// Mem24CSM01 memory(false, false, Wire1); // Chip connected to the second I2C bus
 
 void setup()
 {
 //  debug_init(); // debug only
 
   memory.begin(); // Initialize the I2C bus
+  // memory.begin(MEM24CSM01_CLOCK_FAST_PLUS); // Initialize the I2C bus at 1 MHz
 
   // uint16_t config;
   // Reading the EEPROM Configuration
@@ -33,6 +35,10 @@ void setup()
   // uint8_t byte1 = (manufacturer >> 8) & 0xFF;
   // uint8_t byte2 = (manufacturer >> 16) & 0xFF;
 
+  // The identity is read once by begin(), the getters above do not use the bus
+  // const DeviceIdentity *identity = memory.getIdentity(); // nullptr if the chip did not answer
+  // uint8_t revision = identity->manufacturer.deviceRevision;
+
   // Enabling the Software Write Protection
   // memory.enableSoftwareWriteProtect();
   // config = memory.getConfiguration();
@@ -40,28 +46,35 @@ void setup()
 
   // Disabling the Software Write Protection
   // memory.disableSoftwareWriteProtect();
-  // delay(500);
+  // memory.waitForWriteCompletion(); // ACK polling instead of a fixed delay
   // config = memory.getConfiguration();
   // explainConfig(config);
 
   // Setting the Write Protection Zone
   // memory.setWriteProtectionZone(2);
-  // delay(500);
+  // memory.waitForWriteCompletion(); // ACK polling instead of a fixed delay
   // config = memory.getConfiguration();
   // explainConfig(config);
 
   // Setting the Write Protection Zones with a bitmask
   // memory.writeProtection(0b00010000);
-  // delay(500);
+  // memory.waitForWriteCompletion(); // ACK polling instead of a fixed delay
   // config = memory.getConfiguration();
   // explainConfig(config);
 
   // Removing the Write Protection Zone
   // memory.removeWriteProtectionZone(4);
-  // delay(500);
+  // memory.waitForWriteCompletion(); // ACK polling instead of a fixed delay
   // config = memory.getConfiguration();
   // explainConfig(config);
 
+  // Changing several protection settings with a single write cycle
+  // memory.beginConfigUpdate();
+  // memory.setWriteProtectionZone(0);
+  // memory.setWriteProtectionZone(1);
+  // memory.enableSoftwareWriteProtect();
+  // memory.commitConfig(); // Writes the register once and waits for the write cycle
+
   // Writing a single byte to the EEPROM
   // MEMORYRESULT res;
   // res = memory.write(0x0000, 0x33);
@@ -81,6 +94,55 @@ void setup()
   //   /* code */
   // }
 
+  // Writing a block of any size to the EEPROM, split on page boundaries
+  // uint8_t block[1024];
+  // MEMORYRESULT res;
+  // res = memory.writeBulk(0x00F0, block, sizeof(block));
+  // breakpoint(); // debug only purpose
+  // if (res == OK) {}
+
+  // Writing a block asynchronously, service() must be called from loop() until the write completes
+  // static uint8_t logBlock[4096]; // must stay valid until the write completes
+  // memory.beginWrite(0x1000, logBlock, sizeof(logBlock));
+  // while (memory.service() == BUSY) { /* do something else */ }
+
+  // Saving a settings structure, only the pages holding changed bytes are written
+  // struct { uint16_t counter; uint8_t flags; } settings;
+  // memory.update(0x0100, reinterpret_cast<uint8_t *>(&settings), sizeof(settings));
+
+  // The same with the typed API, the previous copy avoids reading the memory back
+  // struct Settings { uint16_t counter; uint8_t flags; }; // MEM24CSM01_SCHEMA(Settings, 1) at file scope adds a version byte
+  // Settings stored, changed;
+  // memory.get(0x0100, stored);
+  // changed = stored;
+  // changed.counter++;
+  // memory.put(0x0100, changed, stored); // Writes the 2 bytes of counter only
+
+  // Factory reset of the zone 3 and check that it is blank
+  // memory.erase(3);
+  // uint32_t bad;
+  // if (memory.verifyFill(3 * ZONE_SIZE, ERASED_VALUE, ZONE_SIZE, &bad) == MISMATCH) { /* bad holds the first address not erased */ }
+
+  // Saving a configuration blob that survives a power failure during the write (needs MIC24CSM01Atomic.h)
+  // static Mem24CSM01Atomic blob(memory, 0x8000, 512);
+  // blob.begin(); // Finds the newest valid copy
+  // uint8_t image[512];
+  // size_t imageSize;
+  // if (blob.load(image, sizeof(image), &imageSize) != OK) { /* defaults */ }
+  // blob.save(image, imageSize);
+
+  // Logging a sample per wake-up with one write cycle per buffer instead of one per sample (needs MIC24CSM01Batch.h)
+  // static Mem24CSM01Batch samples(memory, 0x10000, 0x10000);
+  // samples.setDeadline(60000); // A sample stays in RAM one minute at most
+  // uint16_t sample = analogRead(A0);
+  // samples.append(reinterpret_cast<uint8_t *>(&sample), sizeof(sample));
+  // while (samples.service() == BUSY) { /* sleep for samples.getIdleTime() microseconds */ }
+  // samples.flush(); // Before a power down
+
+  // Sending the first 4 KiB of the memory to the serial port without a copy buffer (needs MIC24CSM01Stream.h)
+  // Mem24CSM01Stream image(memory, 0x0000, 4096);
+  // while (image.available()) { Serial.write(image.read()); }
+
   // Reading a single byte from the EEPROM based on the current address pointer
   // uint8_t data;
   // MEMORYRESULT res;
@@ -0,0 +1,214 @@
+#include <Arduino.h>
+#include <Wire.h>
+#include <chrono>
+#include <thread>
+
+HardwareSerial Serial;
+TwoWire Wire;
+TwoWire Wire1;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+unsigned long millis()
+{
+  return ((unsigned long)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+unsigned long micros()
+{
+  return ((unsigned long)std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count());
+}
+
+void delay(unsigned long milliseconds)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
+}
+
+void delayMicroseconds(unsigned int microseconds)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(microseconds));
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  (void)pin;
+  (void)value;
+}
+
+int digitalRead(uint8_t pin)
+{
+  (void)pin;
+  return (HIGH); // The lines are pulled up, the bus is always free
+}
+
+size_t Print::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0;
+  while (written < size && write(buffer[written]) == 1)
+  {
+    written++;
+  }
+  return (written);
+}
+
+size_t Print::write(const char *text)
+{
+  return (write((const uint8_t *)text, strlen(text)));
+}
+
+size_t Print::print(const char *text)
+{
+  return (write(text));
+}
+
+size_t Print::print(int value)
+{
+  return (print((long)value));
+}
+
+size_t Print::print(unsigned int value)
+{
+  return (print((unsigned long)value));
+}
+
+size_t Print::print(long value)
+{
+  char text[24];
+  snprintf(text, sizeof(text), "%ld", value);
+  return (write(text));
+}
+
+size_t Print::print(unsigned long value)
+{
+  char text[24];
+  snprintf(text, sizeof(text), "%lu", value);
+  return (write(text));
+}
+
+size_t Print::print(double value, int digits)
+{
+  char text[40];
+  snprintf(text, sizeof(text), "%.*f", digits, value);
+  return (write(text));
+}
+
+size_t Print::println()
+{
+  return (write("\n"));
+}
+
+size_t Print::println(const char *text)
+{
+  return (print(text) + println());
+}
+
+size_t Print::println(unsigned long value)
+{
+  return (print(value) + println());
+}
+
+void HardwareSerial::begin(unsigned long baud)
+{
+  (void)baud;
+}
+
+size_t HardwareSerial::write(uint8_t value)
+{
+  return (fputc(value, stdout) == EOF ? 0 : 1);
+}
+
+int HardwareSerial::available()
+{
+  return (0);
+}
+
+int HardwareSerial::read()
+{
+  return (-1);
+}
+
+int HardwareSerial::peek()
+{
+  return (-1);
+}
+
+void TwoWire::begin()
+{
+  m_tx_length = 0;
+}
+
+void TwoWire::end()
+{
+}
+
+void TwoWire::setClock(uint32_t clock)
+{
+  (void)clock;
+}
+
+void TwoWire::beginTransmission(uint8_t address)
+{
+  (void)address;
+  m_tx_length = 0;
+}
+
+void TwoWire::beginTransmission(int address)
+{
+  beginTransmission((uint8_t)address);
+}
+
+size_t TwoWire::write(uint8_t value)
+{
+  (void)value;
+  if (m_tx_length >= BUFFER_LENGTH)
+  {
+    return (0);
+  }
+  m_tx_length++;
+  return (1);
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t size)
+{
+  return (Print::write(data, size));
+}
+
+uint8_t TwoWire::endTransmission(uint8_t sendStop)
+{
+  (void)sendStop;
+  return (2); // Address not acknowledged
+}
+
+uint8_t TwoWire::requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop)
+{
+  (void)address;
+  (void)quantity;
+  (void)sendStop;
+  return (0);
+}
+
+uint8_t TwoWire::requestFrom(int address, int quantity)
+{
+  return (requestFrom((uint8_t)address, (uint8_t)quantity));
+}
+
+int TwoWire::available()
+{
+  return (0);
+}
+
+int TwoWire::read()
+{
+  return (-1);
+}
+
+int TwoWire::peek()
+{
+  return (-1);
+}
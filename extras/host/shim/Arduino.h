@@ -0,0 +1,88 @@
+/*
+  Arduino - Minimal Arduino core for the host build of the Mem24CSM01 library
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0
+#define OUTPUT 1
+#define INPUT_PULLUP 2
+
+// Pins of the bus recovery, there is no pin on the host
+#define SDA 0
+#define SCL 1
+
+#define bitSet(value, bit) ((value) |= (1UL << (bit)))
+#define bitClear(value, bit) ((value) &= ~(1UL << (bit)))
+#define bitRead(value, bit) (((value) >> (bit)) & 0x01)
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long milliseconds);
+void delayMicroseconds(unsigned int microseconds);
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+
+class Print
+{
+public:
+  Print() : m_write_error(0) {}
+  virtual ~Print() {}
+  int getWriteError() { return (m_write_error); }
+  void clearWriteError() { m_write_error = 0; }
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size);
+  size_t write(const char *text);
+  size_t print(const char *text);
+  size_t print(int value);
+  size_t print(unsigned int value);
+  size_t print(long value);
+  size_t print(unsigned long value);
+  size_t print(double value, int digits = 2);
+  size_t println();
+  size_t println(const char *text);
+  size_t println(unsigned long value);
+  virtual void flush() {}
+
+protected:
+  void setWriteError(int error = 1) { m_write_error = error; }
+
+private:
+  int m_write_error; // Error of the last write, 0 if none
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
+
+// Serial port printing on the standard output
+class HardwareSerial : public Stream
+{
+public:
+  void begin(unsigned long baud);
+  size_t write(uint8_t value);
+  using Print::write;
+  int available();
+  int read();
+  int peek();
+  operator bool() { return (true); }
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  Wire - Minimal Wire library for the host build of the Mem24CSM01 library
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef TwoWire_h
+#define TwoWire_h
+
+#include <Arduino.h>
+
+#define BUFFER_LENGTH 32 // Buffers of the AVR Wire library, the smallest the library supports
+
+// A bus without devices: every address is not acknowledged, the chip is emulated by
+// Mem24CSM01Simulator behind the backend interface instead.
+class TwoWire : public Stream
+{
+public:
+  void begin();
+  void end();
+  void setClock(uint32_t clock);
+  void beginTransmission(uint8_t address);
+  void beginTransmission(int address);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *data, size_t size);
+  using Print::write;
+  uint8_t endTransmission(uint8_t sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity, uint8_t sendStop = true);
+  uint8_t requestFrom(int address, int quantity);
+  int available();
+  int read();
+  int peek();
+
+private:
+  size_t m_tx_length; // Bytes queued since beginTransmission()
+};
+
+extern TwoWire Wire;
+extern TwoWire Wire1;
+
+#endif
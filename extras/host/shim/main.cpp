@@ -0,0 +1,11 @@
+// Runs an Arduino sketch once on the host: setup(), then a single loop().
+
+void setup();
+void loop();
+
+int main()
+{
+  setup();
+  loop();
+  return (0);
+}
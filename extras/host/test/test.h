@@ -0,0 +1,38 @@
+/*
+  test - Assertions of the host tests of the Mem24CSM01 library
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Test_h
+#define MIC24CSM01Test_h
+
+#include <stdio.h>
+
+// Checks a condition, the test goes on and fails at the end
+#define CHECK(condition) checkCondition((condition), #condition, __FILE__, __LINE__)
+
+static int testFailures = 0;
+
+static inline void checkCondition(bool passed, const char *condition, const char *file, int line)
+{
+  if (!passed)
+  {
+    printf("%s:%d: check failed: %s\n", file, line, condition);
+    testFailures++;
+  }
+}
+
+// Exit code of the test, the checks failed are counted
+static inline int testResult()
+{
+  if (testFailures > 0)
+  {
+    printf("%d checks failed\n", testFailures);
+    return (1);
+  }
+  printf("ok\n");
+  return (0);
+}
+
+#endif
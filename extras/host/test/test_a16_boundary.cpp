@@ -0,0 +1,49 @@
+// Blocks crossing the A16 boundary, the bit lives in the device address.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator;
+static uint8_t block[512];
+static uint8_t readBack[512];
+
+int main()
+{
+  uint8_t *array = simulator.getMemory();
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+  for (size_t i = 0; i < sizeof(block); ++i)
+  {
+    block[i] = (uint8_t)(i ^ 0x5A);
+  }
+
+  CHECK(memory.writeBulk(0xFF00, block, sizeof(block)) == MEMORYRESULT::OK);
+  CHECK(memcmp(array + 0xFF00, block, sizeof(block)) == 0);
+  CHECK(array[0x00000] == ERASED_VALUE); // Nothing went to the bottom of the lower half
+  CHECK(memory.read(0xFF00, readBack, sizeof(readBack)) == MEMORYRESULT::OK);
+  CHECK(memcmp(readBack, block, sizeof(block)) == 0);
+
+  // A read starting just before the boundary, with the address pointer already there
+  CHECK(memory.read(0xFFF0, readBack, 8) == MEMORYRESULT::OK);
+  CHECK(memory.read(0xFFF8, readBack + 8, 16) == MEMORYRESULT::OK);
+  CHECK(memcmp(readBack, block + 0xF0, 24) == 0);
+
+  // The raw chip selects the upper half with the A16 bit of the device address
+  simulator.beginTransmission(BASE_MEMREG_ADDR | 1);
+  simulator.write(0x00);
+  simulator.write(0x00);
+  CHECK(simulator.endTransmission() == 0);
+  CHECK(simulator.requestFrom(BASE_MEMREG_ADDR | 1, 1) == 1);
+  CHECK(simulator.read() == block[0x100]);
+
+  // The last bytes of the memory and the limits
+  CHECK(memory.writeBulk(0x1FFF0, block, 16) == MEMORYRESULT::OK);
+  CHECK(memory.read(0x1FFF0, readBack, 16) == MEMORYRESULT::OK);
+  CHECK(memcmp(readBack, block, 16) == 0);
+  CHECK(memory.read(MEMORY_SIZE, readBack, 1) == MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  CHECK(memory.read(0x1FFF0, readBack, 17) == MEMORYRESULT::BUFFER_TOO_LARGE);
+  CHECK(memory.writeBulk(0x1FFF0, block, 17) == MEMORYRESULT::BUFFER_TOO_LARGE);
+
+  return (testResult());
+}
@@ -0,0 +1,54 @@
+// Pages recorded by the ECS bit sampling of the reads.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Simulator.h"
+
+static uint8_t buffer[600];
+
+int main()
+{
+  {
+    // A read running into a suspect zone samples every chunk of the zone
+    Mem24CSM01Simulator simulator;
+    Mem24CSM01 memory(false, false, simulator);
+    memory.begin();
+    simulator.injectEccError(0x4000);
+    memory.setEccSampling(0, 1 << 1);
+    CHECK(memory.read(0x3F00, buffer, sizeof(buffer)) == MEMORYRESULT::OK);
+    uint8_t count = 0;
+    const EccEvent *events = memory.getEccEvents(&count);
+    CHECK(count == 1 && events[0].page == 0x40); // Counted once per chunk of the page
+  }
+  {
+    // A chunk crossing a page boundary records the page needing the correction
+    Mem24CSM01Simulator simulator;
+    Mem24CSM01 memory(false, false, simulator);
+    memory.begin();
+    simulator.injectEccError(0x4100);
+    memory.setEccSampling(0, 1 << 1);
+    CHECK(memory.read(0x40F0, buffer, 32) == MEMORYRESULT::OK);
+    uint8_t count = 0;
+    const EccEvent *events = memory.getEccEvents(&count);
+    CHECK(count == 1 && events[0].page == 0x41);
+  }
+  {
+    // The sampled reads still return the right data
+    Mem24CSM01Simulator simulator;
+    Mem24CSM01 memory(false, false, simulator);
+    memory.begin();
+    for (size_t i = 0; i < sizeof(buffer); ++i)
+    {
+      simulator.getMemory()[0x3F00 + i] = (uint8_t)(i * 3);
+    }
+    memory.setEccSampling(1, 0xFF);
+    CHECK(memory.read(0x3F00, buffer, sizeof(buffer)) == MEMORYRESULT::OK);
+    bool same = true;
+    for (size_t i = 0; i < sizeof(buffer); ++i)
+    {
+      same = same && buffer[i] == (uint8_t)(i * 3);
+    }
+    CHECK(same);
+  }
+  return (testResult());
+}
@@ -0,0 +1,49 @@
+// Keys of the key-value store sharing the same 32-bit hash.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01KeyValue.h"
+#include "MIC24CSM01Simulator.h"
+
+// Two keys with the same FNV-1a hash
+#define FIRST_KEY "k32728"
+#define SECOND_KEY "k261234"
+
+static void checkCollision(Mem24CSM01 &memory, Mem24CSM01Cache *cache)
+{
+  Mem24CSM01KeyValue store(memory, 0x1000, 16, 40, cache);
+  CHECK(store.begin() == MEMORYRESULT::OK);
+  CHECK(store.format() == MEMORYRESULT::OK);
+  const uint8_t first[4] = {1, 2, 3, 4};
+  const uint8_t second[4] = {5, 6, 7, 8};
+  uint8_t value[40];
+  size_t size = 0;
+
+  CHECK(store.put(FIRST_KEY, first, sizeof(first)) == MEMORYRESULT::OK);
+  CHECK(store.get(SECOND_KEY, value, sizeof(value)) == MEMORYRESULT::NOT_FOUND);
+  CHECK(store.put(SECOND_KEY, second, sizeof(second)) == MEMORYRESULT::OK);
+  CHECK(store.get(FIRST_KEY, value, sizeof(value), &size) == MEMORYRESULT::OK);
+  CHECK(size == sizeof(first) && memcmp(value, first, sizeof(first)) == 0);
+  CHECK(store.get(SECOND_KEY, value, sizeof(value), &size) == MEMORYRESULT::OK);
+  CHECK(size == sizeof(second) && memcmp(value, second, sizeof(second)) == 0);
+  CHECK(store.remove(FIRST_KEY) == MEMORYRESULT::OK);
+  CHECK(store.get(FIRST_KEY, value, sizeof(value)) == MEMORYRESULT::NOT_FOUND);
+  CHECK(store.get(SECOND_KEY, value, sizeof(value)) == MEMORYRESULT::OK);
+
+  // The key and the value share the slot
+  uint8_t large[40] = {0};
+  CHECK(store.put("k1", large, 40 - KV_SLOT_HEADER_SIZE - 2) == MEMORYRESULT::OK);
+  CHECK(store.put("k1", large, 40 - KV_SLOT_HEADER_SIZE - 1) == MEMORYRESULT::BUFFER_TOO_LARGE);
+  CHECK(store.flush() == MEMORYRESULT::OK);
+}
+
+int main()
+{
+  Mem24CSM01Simulator simulator;
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+  checkCollision(memory, nullptr);
+  Mem24CSM01Cache cache(memory);
+  checkCollision(memory, &cache);
+  return (testResult());
+}
@@ -0,0 +1,48 @@
+// Address pointer rolling over inside the page on writes.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator;
+
+int main()
+{
+  uint8_t *array = simulator.getMemory();
+  const uint8_t data[4] = {0x11, 0x22, 0x33, 0x44};
+
+  // A raw page write past the end of the page wraps to its first byte
+  simulator.beginTransmission(BASE_MEMREG_ADDR);
+  simulator.write(0x01);
+  simulator.write(0xFE);
+  simulator.write(data, sizeof(data));
+  CHECK(simulator.endTransmission() == 0);
+  CHECK(array[0x1FE] == 0x11 && array[0x1FF] == 0x22);
+  CHECK(array[0x100] == 0x33 && array[0x101] == 0x44);
+  CHECK(array[0x200] == ERASED_VALUE);
+  simulator.delayMicros(WRITE_CYCLE_TIME * 1000);
+
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+
+  // write() refuses the blocks crossing a page boundary
+  uint8_t block[4] = {0xA1, 0xA2, 0xA3, 0xA4};
+  CHECK(memory.write(0x2FE, block, sizeof(block)) == MEMORYRESULT::NOT_ON_SINGLE_PAGE);
+  CHECK(array[0x2FE] == ERASED_VALUE && array[0x200] == ERASED_VALUE);
+  CHECK(memory.write(0x2FC, block, sizeof(block)) == MEMORYRESULT::OK);
+  CHECK(array[0x2FC] == 0xA1 && array[0x2FF] == 0xA4 && array[0x200] == ERASED_VALUE);
+
+  // writeBulk() splits them on the page boundary, one write cycle per page
+  simulator.resetCounters();
+  CHECK(memory.writeBulk(0x3FE, block, sizeof(block)) == MEMORYRESULT::OK);
+  CHECK(simulator.getWriteCycles() == 2);
+  CHECK(array[0x3FE] == 0xA1 && array[0x3FF] == 0xA2 && array[0x400] == 0xA3 && array[0x401] == 0xA4);
+  CHECK(array[0x300] == ERASED_VALUE);
+
+  // Reads run over the page boundaries
+  uint8_t readBack[4];
+  CHECK(memory.read(0x3FE, readBack, sizeof(readBack)) == MEMORYRESULT::OK);
+  CHECK(memcmp(readBack, block, sizeof(block)) == 0);
+
+  return (testResult());
+}
@@ -0,0 +1,68 @@
+// Writes to the zones protected in Enhanced Software Write Protection Mode.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Cache.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator;
+static uint8_t block[ZONE_SIZE + 32];
+
+int main()
+{
+  uint8_t *array = simulator.getMemory();
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+  Mem24CSM01Cache cache(memory);
+  memset(block, 0x42, sizeof(block));
+
+  uint8_t value = 0x10;
+  CHECK(cache.write(ZONE_SIZE + 0x100, &value, 1) == MEMORYRESULT::OK); // Cached before the zone is protected
+
+  CHECK(memory.enableSoftwareWriteProtect());
+  CHECK(memory.setWriteProtectionZone(1));
+  memory.waitForWriteCompletion();
+  CHECK((simulator.getConfigurationRegister() & (EWPM_MASK)) != 0);
+  CHECK((simulator.getConfigurationRegister() & 0xFF) == 0x02);
+  CHECK(memory.protectedSize(ZONE_SIZE - 16, 32) == 0);
+  CHECK(memory.protectedSize(ZONE_SIZE, 32) == 32);
+
+  // The chip does not acknowledge the data of a protected page
+  simulator.beginTransmission(BASE_MEMREG_ADDR);
+  simulator.write((uint8_t)(ZONE_SIZE >> 8));
+  simulator.write(0x00);
+  simulator.write(0x55);
+  CHECK(simulator.endTransmission() == 3);
+  CHECK(array[ZONE_SIZE] == ERASED_VALUE);
+
+  // The driver detects the protection without using the bus
+  simulator.resetCounters();
+  CHECK(memory.write(ZONE_SIZE + 1, 0x55) == MEMORYRESULT::WRITE_PROTECTED);
+  CHECK(simulator.getTransactions() == 0);
+  CHECK(array[ZONE_SIZE + 1] == ERASED_VALUE);
+
+  // Blocks partially protected are written around the zone
+  CHECK(memory.writeBulk(ZONE_SIZE - 16, block, sizeof(block)) == MEMORYRESULT::WRITE_PROTECTED);
+  CHECK(array[ZONE_SIZE - 16] == 0x42 && array[ZONE_SIZE - 1] == 0x42);
+  CHECK(array[ZONE_SIZE] == ERASED_VALUE && array[2 * ZONE_SIZE - 1] == ERASED_VALUE);
+  CHECK(array[2 * ZONE_SIZE] == 0x42 && array[2 * ZONE_SIZE + 15] == 0x42);
+  CHECK(array[2 * ZONE_SIZE + 16] == ERASED_VALUE);
+
+  // The cache reports the page protected after it was cached once, then keeps working
+  CHECK(cache.flush() == MEMORYRESULT::WRITE_PROTECTED);
+  CHECK(!cache.isDirty());
+  CHECK(cache.flush() == MEMORYRESULT::OK);
+  CHECK(cache.write(ZONE_SIZE + 0x200, &value, 1) == MEMORYRESULT::WRITE_PROTECTED);
+  CHECK(!cache.isDirty());
+  CHECK(cache.write(0x100, &value, 1) == MEMORYRESULT::OK);
+  CHECK(cache.flush() == MEMORYRESULT::OK);
+  memory.waitForWriteCompletion();
+  CHECK(array[0x100] == 0x10);
+
+  CHECK(memory.removeWriteProtectionZone(1));
+  CHECK(memory.write(ZONE_SIZE + 1, 0x55) == MEMORYRESULT::OK);
+  memory.waitForWriteCompletion();
+  CHECK(array[ZONE_SIZE + 1] == 0x55);
+
+  return (testResult());
+}
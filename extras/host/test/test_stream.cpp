@@ -0,0 +1,36 @@
+// Stream reads served from the receive buffer while other drivers use the bus.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Stream.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator;
+
+int main()
+{
+  uint8_t *array = simulator.getMemory();
+  for (uint16_t i = 0; i < 64; ++i)
+  {
+    array[i] = (uint8_t)i;
+  }
+  Mem24CSM01 memory(false, false, simulator);
+  Mem24CSM01 other(false, false, simulator); // Another driver object on the same bus, e.g. a Mem24CSM01Array member
+  memory.begin();
+
+  Mem24CSM01Stream stream(memory, 0, 64);
+  CHECK(stream.read() == 0);
+  uint32_t before = memory.getTransactionCount();
+  uint8_t value;
+  other.read(0x1000, &value);
+  CHECK(memory.getTransactionCount() != before);
+  bool same = true;
+  for (int i = 1; i < 64; ++i)
+  {
+    same = same && stream.read() == i;
+  }
+  CHECK(same);
+  CHECK(stream.read() == -1);
+
+  return (testResult());
+}
@@ -0,0 +1,56 @@
+// Transfers limited by the 32 bytes Wire buffers of the AVR boards.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator(false, false, 32);
+static Mem24CSM01Simulator smallSimulator(false, false, 16); // Buffers smaller than the driver expects
+
+int main()
+{
+  CHECK(MEM24CSM01_WIRE_BUFFER_SIZE == 32);
+  CHECK(MEM24CSM01_WRITE_CHUNK_SIZE == 30);
+  CHECK(MEM24CSM01_READ_CHUNK_SIZE == 32);
+
+  // The simulated Wire buffers drop the bytes past their size
+  uint8_t data[64];
+  for (size_t i = 0; i < sizeof(data); ++i)
+  {
+    data[i] = (uint8_t)(i + 1);
+  }
+  simulator.beginTransmission(BASE_MEMREG_ADDR);
+  CHECK(simulator.write(data, sizeof(data)) == 32);
+  CHECK(simulator.endTransmission() == 0);
+  simulator.delayMicros(WRITE_CYCLE_TIME * 1000);
+  CHECK(simulator.requestFrom(BASE_MEMREG_ADDR, 40) == 32);
+
+  // The driver splits the pages in chunks fitting the buffer
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+  static uint8_t block[300];
+  static uint8_t readBack[300];
+  for (size_t i = 0; i < sizeof(block); ++i)
+  {
+    block[i] = (uint8_t)(i * 7);
+  }
+  simulator.resetCounters();
+  CHECK(memory.writeBulk(0x1000, block, sizeof(block)) == MEMORYRESULT::OK);
+  CHECK(simulator.getWriteCycles() == 11); // 256 bytes in 9 chunks, then 44 bytes in 2 chunks
+  CHECK(memcmp(simulator.getMemory() + 0x1000, block, sizeof(block)) == 0);
+  size_t bytesRead = 0;
+  CHECK(memory.read(0x1000, readBack, sizeof(readBack), &bytesRead) == MEMORYRESULT::OK);
+  CHECK(bytesRead == sizeof(readBack));
+  CHECK(memcmp(readBack, block, sizeof(block)) == 0);
+
+  // A truncated transfer is reported, never returned as OK
+  Mem24CSM01 smallMemory(false, false, smallSimulator);
+  smallMemory.begin();
+  CHECK(smallMemory.write(0x2000, block, 20) == MEMORYRESULT::WIRE_BUFFER_OVERFLOW);
+  CHECK(smallMemory.writeBulk(0x2000, block, 14) == MEMORYRESULT::OK);
+  CHECK(smallMemory.read(0x2000, readBack, 20, &bytesRead) == MEMORYRESULT::GENERIC_ERROR);
+  CHECK(bytesRead == 16);
+  CHECK(memcmp(readBack, block, 14) == 0);
+
+  return (testResult());
+}
@@ -0,0 +1,71 @@
+// NACK during the write cycle, timed on the virtual clock of the simulator.
+
+#include "test.h"
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Batch.h"
+#include "MIC24CSM01Simulator.h"
+
+static Mem24CSM01Simulator simulator;
+
+int main()
+{
+  Mem24CSM01 memory(false, false, simulator);
+  memory.begin();
+
+  // The chip does not acknowledge its address until the write cycle is over
+  CHECK(memory.write(0x10, 0xAA) == MEMORYRESULT::OK);
+  simulator.beginTransmission(BASE_MEMREG_ADDR);
+  CHECK(simulator.endTransmission() == 2);
+  CHECK(memory.isWriteCycleActive());
+  uint32_t remaining = memory.getWriteCycleRemaining();
+  CHECK(remaining > 0 && remaining <= WRITE_CYCLE_TIME * 1000UL);
+  simulator.delayMicros(WRITE_CYCLE_TIME * 1000UL);
+  CHECK(!memory.isWriteCycleActive());
+  CHECK(memory.getWriteCycleRemaining() == 0);
+  simulator.beginTransmission(BASE_MEMREG_ADDR);
+  CHECK(simulator.endTransmission() == 0);
+
+  // The ACK polling waits for the end of the cycle measured on the virtual clock
+  CHECK(memory.write(0x11, 0xBB) == MEMORYRESULT::OK);
+  uint64_t start = simulator.getElapsedNanos();
+  CHECK(memory.waitForWriteCompletion() == MEMORYRESULT::OK);
+  uint64_t waited = simulator.getElapsedNanos() - start;
+  CHECK(waited >= (WRITE_CYCLE_TIME - 1) * 1000000ULL && waited < (WRITE_CYCLE_TIME + 1) * 1000000ULL);
+  CHECK(!memory.isWriteInProgress());
+
+  // The timeout runs on the same clock, with the millisecond resolution of getMillis()
+  simulator.setWriteCycleTime(3 * WRITE_CYCLE_TIMEOUT * 1000UL);
+  CHECK(memory.write(0x12, 0xCC) == MEMORYRESULT::OK);
+  start = simulator.getElapsedNanos();
+  CHECK(memory.waitForWriteCompletion() == MEMORYRESULT::TIMEOUT);
+  waited = simulator.getElapsedNanos() - start;
+  CHECK(waited >= (WRITE_CYCLE_TIMEOUT - 1) * 1000000ULL && waited < (WRITE_CYCLE_TIMEOUT + 1) * 1000000ULL);
+  simulator.delayMicros(3 * WRITE_CYCLE_TIMEOUT * 1000UL);
+  CHECK(memory.waitForWriteCompletion() == MEMORYRESULT::OK);
+  simulator.setWriteCycleTime(WRITE_CYCLE_TIME * 1000UL);
+
+  // The retry backoff waits on the virtual clock as well
+  RetryPolicy policy = {3, 2000, RETRY_ON(MEMORYRESULT::ADDRESS_ERROR), 0};
+  Mem24CSM01 absent(true, true, simulator); // No chip answers at this address
+  absent.setRetryPolicy(policy);
+  start = simulator.getElapsedNanos();
+  CHECK(absent.write(0x10, 0x00) != MEMORYRESULT::OK);
+  CHECK(simulator.getElapsedNanos() - start >= (2000ULL + 4000ULL) * 1000ULL);
+
+  // The asynchronous engine and the batch deadline follow the virtual clock
+  Mem24CSM01Batch batch(memory, 0x1000, 0x1000);
+  batch.setDeadline(20);
+  uint8_t record[4] = {1, 2, 3, 4};
+  CHECK(batch.append(record, sizeof(record)) == MEMORYRESULT::OK);
+  uint32_t idle = batch.getIdleTime();
+  CHECK(idle > 19000 && idle <= 20000);
+  CHECK(batch.service() == MEMORYRESULT::OK && batch.pending() == sizeof(record));
+  simulator.delayMicros(idle);
+  CHECK(batch.getIdleTime() == 0);
+  batch.service();
+  CHECK(batch.pending() == 0);
+  CHECK(batch.flush() == MEMORYRESULT::OK);
+  CHECK(memcmp(simulator.getMemory() + 0x1000, record, sizeof(record)) == 0);
+
+  return (testResult());
+}
@@ -1,5 +1,62 @@
 #include "MIC24CSM01.h"
 
+// Statistics helpers, they compile to nothing when MEM24CSM01_ENABLE_STATS is not defined
+#ifdef MEM24CSM01_ENABLE_STATS
+#define STATS_START() unsigned long statsStart = m_bus->getMicros()
+#define STATS_COUNT(field, value) m_stats.field += (value)
+#define STATS_RECORD(operation, address, size, result) recordTransaction(operation, address, size, result, statsStart)
+#else
+#define STATS_START()
+#define STATS_COUNT(field, value)
+#define STATS_RECORD(operation, address, size, result)
+#endif
+
+// Bus lock held by the public operations for their whole duration, it compiles to nothing when MEM24CSM01_ENABLE_RTOS is not defined
+#ifdef MEM24CSM01_ENABLE_RTOS
+namespace
+{
+  class Mem24CSM01Lock
+  {
+  public:
+    Mem24CSM01Lock(SemaphoreHandle_t mutex, uint8_t *depth) : m_mutex(mutex), m_depth(depth)
+    {
+      xSemaphoreTakeRecursive(m_mutex, portMAX_DELAY);
+      (*m_depth)++;
+    }
+    ~Mem24CSM01Lock()
+    {
+      (*m_depth)--;
+      xSemaphoreGiveRecursive(m_mutex);
+    }
+    // Releases every level of the lock held by the calling task, waits a tick and takes them again
+    static void yield(SemaphoreHandle_t mutex, uint8_t *depth)
+    {
+      uint8_t held = *depth;
+      *depth = 0;
+      for (uint8_t i = 0; i < held; ++i)
+      {
+        xSemaphoreGiveRecursive(mutex);
+      }
+      vTaskDelay(1);
+      for (uint8_t i = 0; i < held; ++i)
+      {
+        xSemaphoreTakeRecursive(mutex, portMAX_DELAY);
+      }
+      *depth = held;
+    }
+
+  private:
+    SemaphoreHandle_t m_mutex;
+    uint8_t *m_depth;
+  };
+}
+#define MEM24CSM01_LOCK() Mem24CSM01Lock busLock(m_mutex, &m_lock_depth)
+#define MEM24CSM01_YIELD() Mem24CSM01Lock::yield(m_mutex, &m_lock_depth) // The other tasks use the bus during a write cycle
+#else
+#define MEM24CSM01_LOCK()
+#define MEM24CSM01_YIELD()
+#endif
+
 /**
  * @brief Generates a protection pattern based on the input zone protection flags.
  *
@@ -32,11 +89,11 @@ uint8_t zoneProtection(bool zone7, bool zone6, bool zone5, bool zone4, bool zone
  * memory configuration register.
  *
  * @param word_mem_acc The memory register value.
+ * @param wire The I2C bus the chip is connected to, default is Wire.
  */
-Mem24CSM01::Mem24CSM01(uint8_t word_mem_acc)
+Mem24CSM01::Mem24CSM01(uint8_t word_mem_acc, TwoWire &wire) : m_wire_backend(wire)
 {
-  m_dev_address_memory_access = word_mem_acc;
-  m_dev_address_configuration_reg = m_dev_address_memory_access | (1 << 4); // from 0b1010xxxx to 0b1011xxxx
+  init(word_mem_acc, word_mem_acc | (1 << 3)); // from 0b1010xxx to 0b1011xxx
 }
 
 /**
@@ -47,22 +104,115 @@ Mem24CSM01::Mem24CSM01(uint8_t word_mem_acc)
  *
  * @param A1 The A1 address bit (Chip PIN A1 (2) VCC = 1, VSS = 0).
  * @param A2 The A2 address bit (Chip PIN A2 (3) VCC = 1, VSS = 0).
+ * @param wire The I2C bus the chip is connected to, default is Wire.
+ */
+Mem24CSM01::Mem24CSM01(bool A1, bool A2, TwoWire &wire) : m_wire_backend(wire)
+{
+  init(BASE_MEMREG_ADDR | (A2 << 2) | (A1 << 1), BASE_CFGREG_ADDR | (A2 << 2) | (A1 << 1)); // 0b1010 A2 A1 0 and 0b1011 A2 A1 0
+}
+
+/**
+ * @brief Constructor for the Mem24CSM01 class using a custom bus backend.
+ *
+ * The backend replaces the Wire library for every bus transaction, e.g. a platform driver
+ * transferring the pages with DMA, see Mem24CSM01Backend.
+ *
+ * @param A1 The A1 address bit (Chip PIN A1 (2) VCC = 1, VSS = 0).
+ * @param A2 The A2 address bit (Chip PIN A2 (3) VCC = 1, VSS = 0).
+ * @param backend The bus backend, it must outlive the object.
+ */
+Mem24CSM01::Mem24CSM01(bool A1, bool A2, Mem24CSM01Backend &backend) : Mem24CSM01(A1, A2)
+{
+  m_bus = &backend;
+}
+
+/**
+ * @brief Initializes the state shared by the constructors.
+ *
+ * The object starts on the Wire backend with the default write timeout, no retries
+ * and nothing known about the chip, the registers are read by begin().
+ *
+ * @param memoryAddress The device address byte for the memory access.
+ * @param configAddress The device address byte for the configuration and security registers.
  */
-Mem24CSM01::Mem24CSM01(bool A1, bool A2)
+void Mem24CSM01::init(uint8_t memoryAddress, uint8_t configAddress)
 {
-  m_dev_address_memory_access = BASE_MEMREG_ADDR | (A2 << 3) | (A1 << 2);     // 0b1010 A2 A1 00
-  m_dev_address_configuration_reg = BASE_CFGREG_ADDR | (A2 << 3) | (A1 << 2); // 0b1011 A2 A1 00
-  m_dev_address_security_register = m_dev_address_configuration_reg;          // 0b1011 A2 A1 00
+  m_bus = &m_wire_backend;
+  m_dev_address_memory_access = memoryAddress;
+  m_dev_address_configuration_reg = configAddress;
+  m_dev_address_security_register = configAddress;
+  m_write_timeout = WRITE_CYCLE_TIMEOUT;
+  m_write_in_progress = false;
+  m_write_cycle_start = 0;
+  m_async_state = ASYNCWRITESTATE::ASYNC_IDLE;
+  m_async_result = MEMORYRESULT::OK;
+  m_async_callback = nullptr;
+  m_async_protected = false;
+  m_async_attempt = 0;
+  m_clock = 0;
+  m_high_speed = false;
+  m_bus_held = false;
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN;
+  m_identity_loaded = false;
+#ifdef MEM24CSM01_ENABLE_RTOS
+  m_mutex = xSemaphoreCreateRecursiveMutex();
+  m_lock_depth = 0;
+#endif
+  m_retry_policy.maxAttempts = 1;
+  m_retry_policy.backoffMicros = 0;
+  m_retry_policy.retryMask = DEFAULT_RETRY_MASK;
+  m_retry_policy.busRecoveryThreshold = 0;
+  m_failure_count = 0;
+  m_sda_pin = SDA;
+  m_scl_pin = SCL;
+  m_config_loaded = false;
+  m_config_transaction = false;
+  m_config_locked_on_chip = false;
+  m_config_value = 0;
+  m_ecc_interval = 0;
+  m_ecc_suspect_zones = 0;
+  m_ecc_read_count = 0;
+  clearEccEvents();
+#ifdef MEM24CSM01_ENABLE_STATS
+  m_trace_callback = nullptr;
+  resetStatistics();
+#endif
 }
 
 /**
  * @brief Initializes the Mem24CSM01 device.
  *
- * This function initializes the I2C bus, preparing the device for communication.
+ * This function initializes the I2C bus, preparing the device for communication, and
+ * optionally sets the bus clock. The chip supports up to 1 MHz (Fast-mode Plus) and
+ * 3.4 MHz in high-speed mode. High-speed mode requires the master code to be sent at
+ * 400 kHz before every transaction, it is used only when the library is built with
+ * MEM24CSM01_ENABLE_HS_MODE and the platform Wire library keeps the bus after a not
+ * acknowledged transmission ended with a repeated start. Otherwise the clock is
+ * limited to Fast-mode Plus.
+ *
+ * @param clock The I2C bus clock frequency in Hz, 0 keeps the Wire library default
+ *              (useful when the bus is shared and already configured).
  */
-void Mem24CSM01::begin()
+void Mem24CSM01::begin(uint32_t clock)
 {
-  Wire.begin(); // Initialize the I2C bus
+  MEM24CSM01_LOCK();
+  m_bus->begin(); // Initialize the I2C bus
+#ifndef MEM24CSM01_ENABLE_HS_MODE
+  if (clock > MEM24CSM01_CLOCK_FAST_PLUS)
+  {
+    clock = MEM24CSM01_CLOCK_FAST_PLUS;
+  }
+#endif
+  m_clock = clock;
+  m_high_speed = clock > MEM24CSM01_CLOCK_FAST_PLUS;
+  if (clock != 0)
+  {
+    m_bus->setClock(clock);
+  }
+  if (!m_identity_loaded)
+  {
+    refreshIdentity(); // On failure the getters try again
+  }
 }
 
 /**
@@ -72,9 +222,10 @@ void Mem24CSM01::begin()
  * register. It sends the address of the configuration register, requests two bytes of
  * data, and then processes these bytes to extract various configuration settings.
  *
- * @return uint16_t The 16-bit value read from the configuration register.
+ * @return uint16_t The 16-bit value read from the configuration register, 0 if the read failed.
  *
- * - Extracts and updates the following configuration settings:
+ * - Extracts and updates the following configuration settings, only the ECC bit while a
+ *   batch started by beginConfigUpdate() is open:
  *   - `zoneProtection`: The lower byte of the configuration register.
  *   - `isConfigLocked`: The LOCK bit from the configuration register.
  *   - `isSoftwareWriteProtect`: The EWPM bit from the configuration register.
@@ -82,30 +233,89 @@ void Mem24CSM01::begin()
  */
 uint16_t Mem24CSM01::getConfiguration()
 {
-  uint16_t result;   // Variable to store the two concatenated bytes read from the device
-  uint8_t low, high; // Variables to store the two single bytes read from the device
-
-  Wire.beginTransmission(m_dev_address_configuration_reg);                      // Start the transmission with the device
-  Wire.write(CFGREG_WRD_ADDRH);                                                 // Write the first word address byte
-  Wire.write(CFGREG_WRD_ADDRL);                                                 // Write the second word address byte
-  Wire.endTransmission(false);                                                  // Send a restart message to keep the bus open
-  Wire.requestFrom(m_dev_address_configuration_reg, (uint8_t)2, (uint8_t)true); // Request 2 bytes from the device
-  high = Wire.read();                                                           // Read the first byte
-  low = Wire.read();                                                            // Read the second byte
-  result = (high << 8) | low;                                                   // Concatenate the two bytes
-  m_configuration.zoneProtection = low;
-  m_configuration.isConfigLocked = result & LOCK_MASK;          // Extract the LOCK bit
-  m_configuration.isSoftwareWriteProtect = result & EWPM_MASK;  // Extract the EWPM bit
+  MEM24CSM01_LOCK();
+  uint16_t result; // Variable to store the two concatenated bytes read from the device
+  if (!readConfigRegister(&result))
+  {
+    return (0);
+  }
   m_configuration.isErrorCorrectionOccured = result & ECS_MASK; // Extract the ECC bit
+  if (m_config_transaction) // Keep the pending changes, the register still holds the old values
+  {
+    return (result);
+  }
+  m_configuration.zoneProtection = result & 0xFF;
+  m_configuration.isConfigLocked = result & LOCK_MASK;         // Extract the LOCK bit
+  m_configuration.isSoftwareWriteProtect = result & EWPM_MASK; // Extract the EWPM bit
+  m_config_value = result & CONFIG_VALUE_MASK;
+  m_config_locked_on_chip = m_configuration.isConfigLocked;
+  m_config_loaded = true;
   return (result);
 }
 
+/**
+ * @brief Starts a batch of configuration changes.
+ *
+ * The configuration register is read if it has not been read yet, then the changes made by
+ * enableSoftwareWriteProtect(), disableSoftwareWriteProtect(), setWriteProtectionZone(),
+ * removeWriteProtectionZone() and writeProtection() are only applied to the local copy
+ * until commitConfig() writes them with a single write cycle.
+ *
+ * @return true if the batch has started, false if the register could not be read or is locked.
+ */
+bool Mem24CSM01::beginConfigUpdate()
+{
+  MEM24CSM01_LOCK();
+  if (!loadConfiguration() || m_configuration.isConfigLocked)
+  {
+    return (false);
+  }
+  m_config_transaction = true;
+  return (true);
+}
+
+/**
+ * @brief Writes the configuration changes made since beginConfigUpdate().
+ *
+ * The register is written once, and only if the changes modify it, then the end of the
+ * write cycle is awaited with ACK polling.
+ *
+ * @return true if the configuration has been written, false otherwise.
+ */
+bool Mem24CSM01::commitConfig()
+{
+  MEM24CSM01_LOCK();
+  if (!m_config_transaction)
+  {
+    return (false);
+  }
+  m_config_transaction = false;
+  if (configValue() == m_config_value)
+  {
+    return (true); // Nothing changed, no write cycle needed
+  }
+  if (!updateConfigRegister())
+  {
+    return (false);
+  }
+  return (waitForWriteCompletion() == MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Discards the configuration changes made since beginConfigUpdate().
+ */
+void Mem24CSM01::cancelConfigUpdate()
+{
+  MEM24CSM01_LOCK();
+  m_config_transaction = false;
+  m_config_loaded = false; // The local copy is read again at the next change
+}
+
 /**
  * @brief Retrieves the serial number from the EEPROM device.
  *
- * This function reads the serial number from the security register of the EEPROM device
- * and stores it in the provided data array. The array size must match the expected serial
- * number byte size.
+ * The serial number is read from the security register once, by begin() or by the first
+ * call, then it is served from the identity cache without using the bus.
  *
  * @param data Pointer to the array where the serial number will be stored.
  * @param arraySize Size of the provided data array. Must be equal to SERIAL_NUMBER_BYTE_SIZE.
@@ -117,42 +327,156 @@ bool Mem24CSM01::getSerialNumber(uint8_t *data, uint8_t arraySize)
   {
     return (false);
   }
-  Wire.beginTransmission(m_dev_address_security_register);
-  Wire.write(SECREG_WRD_ADDRH);
-  Wire.write(SECREG_WRD_ADDRL);
-  Wire.endTransmission(false);
-  Wire.requestFrom(m_dev_address_security_register, (uint8_t)16, (uint8_t)true); // Request 16 bytes from the device
-  for (int nBytes = 0; nBytes < arraySize; nBytes++)
+  const DeviceIdentity *identity = getIdentity();
+  if (identity == nullptr)
   {
-    data[nBytes] = Wire.read();
+    return (false);
   }
+  memcpy(data, identity->serialNumber, SERIAL_NUMBER_BYTE_SIZE);
   return (true);
 }
 
 /**
  * @brief Retrieves the manufacturer register value from the EEPROM device.
  *
- * This function communicates with the EEPROM device to read the manufacturer
- * register, which consists of three bytes. The bytes are concatenated into a
- * single 32-bit unsigned integer and returned.
+ * The register consists of three bytes concatenated into a single value. It is read once,
+ * by begin() or by the first call, then it is served from the identity cache.
+ *
+ * @return uint64_t The concatenated manufacturer register value, 00D0D0h for the 24CSM01,
+ *         0 if the register could not be read or does not hold the Microchip manufacturer code.
+ */
+uint64_t Mem24CSM01::getManufacturerRegister()
+{
+  const DeviceIdentity *identity = getIdentity();
+  return (identity == nullptr ? 0 : identity->manufacturerRegister);
+}
+
+/**
+ * @brief Returns the identity of the chip, read at the first call if begin() could not read it.
+ *
+ * @return const DeviceIdentity* The cached identity, nullptr if it could not be read.
+ */
+const DeviceIdentity *Mem24CSM01::getIdentity()
+{
+  MEM24CSM01_LOCK();
+  if (!m_identity_loaded && refreshIdentity() != MEMORYRESULT::OK)
+  {
+    return (nullptr);
+  }
+  return (&m_identity);
+}
+
+/**
+ * @brief Reads again the manufacturer register and the serial number into the identity cache.
+ *
+ * The manufacturer register is checked against MANUFACTURER_CODE_MICROCHIP, so another device
+ * answering on the bus is not taken for the memory. The cache stays empty on failure.
  *
- * @return uint64_t The concatenated manufacturer register value.
+ * @return MEMORYRESULT OK if both registers have been read, MISMATCH if the manufacturer code is not
+ *         the Microchip one, otherwise the result of the failed read.
  */
-uint64_t Mem24CSM01::getManufacturerRegister() // TODO return error code
+MEMORYRESULT Mem24CSM01::refreshIdentity()
 {
-  uint32_t result; // Variable to store the two concatenated bytes read from the device
+  MEM24CSM01_LOCK();
+  m_identity_loaded = false;
+  uint32_t value;
+  MEMORYRESULT result = readManufacturerRegister(&value);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  if ((value >> 12) != MANUFACTURER_CODE_MICROCHIP)
+  {
+    return (MEMORYRESULT::MISMATCH);
+  }
+  result = readSerialNumber(m_identity.serialNumber);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  m_identity.manufacturerRegister = value;
+  m_identity.manufacturer.manufacturer = value >> 12;           // Bits 23 to 12
+  m_identity.manufacturer.deviceDensity = (value >> 3) & 0x1FF; // Bits 11 to 3
+  m_identity.manufacturer.deviceRevision = value & 0x07;        // Bits 2 to 0
+  m_identity_loaded = true;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the serial number from the security register.
+ *
+ * @param data Pointer to the array of SERIAL_NUMBER_BYTE_SIZE bytes receiving the serial number.
+ * @return MEMORYRESULT The result of the read, GENERIC_ERROR if bytes are missing.
+ */
+MEMORYRESULT Mem24CSM01::readSerialNumber(uint8_t *data)
+{
+  MEMORYRESULT result = waitForWriteCompletion(); // The chip does not answer during a write cycle
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  uint8_t attempt = 0;
+  do
+  {
+    STATS_START();
+    beginTransmission(m_dev_address_security_register);
+    m_bus->write(SECREG_WRD_ADDRH);
+    m_bus->write(SECREG_WRD_ADDRL);
+    result = processTransmissionResult(endTransmission(false));
+    if (result == MEMORYRESULT::OK && requestFrom(m_dev_address_security_register, SERIAL_NUMBER_BYTE_SIZE) != SERIAL_NUMBER_BYTE_SIZE)
+    {
+      result = MEMORYRESULT::GENERIC_ERROR;
+    }
+    STATS_RECORD(BUSOPERATION::BUS_CONFIGURATION, 0, SERIAL_NUMBER_BYTE_SIZE, result);
+  } while (retryAfter(result, &attempt));
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  for (int nBytes = 0; nBytes < SERIAL_NUMBER_BYTE_SIZE; nBytes++)
+  {
+    data[nBytes] = m_bus->read();
+  }
+  return (MEMORYRESULT::OK);
+}
 
-  Wire.beginTransmission(FIRST_RESERVED_HOST_CODE);
-  Wire.write(m_dev_address_memory_access << 1);
-  Wire.endTransmission(false);
-  Wire.requestFrom((uint8_t)SECOND_RESERVED_HOST_CODE, (uint8_t)3, (uint8_t)true); // Request 3 bytes from the device
+/**
+ * @brief Reads the manufacturer register with the reserved host code sequence.
+ *
+ * @param value Pointer where the three bytes concatenated are stored.
+ * @return MEMORYRESULT The result of the read, GENERIC_ERROR if bytes are missing.
+ */
+MEMORYRESULT Mem24CSM01::readManufacturerRegister(uint32_t *value)
+{
+  MEMORYRESULT result = waitForWriteCompletion(); // The chip does not answer during a write cycle
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  uint8_t attempt = 0;
+  do
+  {
+    STATS_START();
+    beginTransmission(FIRST_RESERVED_HOST_CODE);
+    m_bus->write(m_dev_address_memory_access << 1);
+    result = processTransmissionResult(endTransmission(false));
+    if (result == MEMORYRESULT::OK && requestFrom(SECOND_RESERVED_HOST_CODE, MANUFACTURER_REGISTER_BYTE_SIZE) != MANUFACTURER_REGISTER_BYTE_SIZE)
+    {
+      result = MEMORYRESULT::GENERIC_ERROR;
+    }
+    STATS_RECORD(BUSOPERATION::BUS_CONFIGURATION, 0, MANUFACTURER_REGISTER_BYTE_SIZE, result);
+  } while (retryAfter(result, &attempt));
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
   uint8_t byte0, byte1, byte2;
-  byte0 = Wire.read(); // Read the first byte
-  byte1 = Wire.read(); // Read the second byte
-  byte2 = Wire.read(); // Read the third byte
-  result = (static_cast<uint32_t>(byte0) << 16) | (static_cast<uint32_t>(byte1) << 8) |
+  byte0 = m_bus->read(); // Read the first byte
+  byte1 = m_bus->read(); // Read the second byte
+  byte2 = m_bus->read(); // Read the third byte
+  *value = (static_cast<uint32_t>(byte0) << 16) | (static_cast<uint32_t>(byte1) << 8) |
            static_cast<uint32_t>(byte2); // Concatenate the three bytes
-  return (result);
+  return (MEMORYRESULT::OK);
 }
 
 // Parameters: confirmLock - 66h unlocked, 99h locked - default is unlocked
@@ -174,29 +498,59 @@ uint64_t Mem24CSM01::getManufacturerRegister() // TODO return error code
  */
 bool Mem24CSM01::updateConfigRegister(uint8_t confirmLock)
 {
+  MEM24CSM01_LOCK();
+  if (!loadConfiguration())
+  {
+    return (false);
+  }
+  if (m_config_locked_on_chip) // The chip ignores the write, do not waste a write cycle
+  {
+    return (false);
+  }
   // Preparing the config bytes
   uint8_t cfgHighByte = 0 | (m_configuration.isSoftwareWriteProtect << 1) | m_configuration.isConfigLocked;
   uint8_t cfgLowByte = m_configuration.zoneProtection;
+  if (waitForWriteCompletion() != MEMORYRESULT::OK)
+  {
+    return (false);
+  }
 
   // Writing the configuration bytes to the device
-  Wire.beginTransmission(m_dev_address_configuration_reg); // Start the transmission with the device
-  Wire.write(CFGREG_WRD_ADDRH);                            // Write the first word address byte
-  Wire.write(CFGREG_WRD_ADDRL);                            // Write the second word address byte
-  Wire.write(cfgHighByte);                                 // Write the high byte of the configuration
-  Wire.write(cfgLowByte);                                  // Write the low byte of the configuration
-  Wire.write(confirmLock);                                 // Write the confirmation byte
-  if (Wire.endTransmission() != 0)                         // End the transmission and check for errors
+  MEMORYRESULT result;
+  uint8_t attempt = 0;
+  do
+  {
+    STATS_START();
+    beginTransmission(m_dev_address_configuration_reg); // Start the transmission with the device
+    m_bus->write(CFGREG_WRD_ADDRH);                     // Write the first word address byte
+    m_bus->write(CFGREG_WRD_ADDRL);                     // Write the second word address byte
+    m_bus->write(cfgHighByte);                          // Write the high byte of the configuration
+    m_bus->write(cfgLowByte);                           // Write the low byte of the configuration
+    m_bus->write(confirmLock);                          // Write the confirmation byte
+    result = processTransmissionResult(endTransmission()); // End the transmission and check for errors
+    STATS_RECORD(BUSOPERATION::BUS_CONFIGURATION, 0, 3, result);
+  } while (retryAfter(result, &attempt));
+  if (result != MEMORYRESULT::OK)
   {
     return (false);
   }
+  m_write_in_progress = true; // The configuration register is written with a write cycle as well
+  m_write_cycle_start = m_bus->getMicros();
+  m_config_value = configValue();
+  m_config_locked_on_chip = confirmLock == REGISTER_LOCKED && m_configuration.isConfigLocked;
   return (true);
 }
 
 
 bool Mem24CSM01::enableSoftwareWriteProtect()
 {
+  MEM24CSM01_LOCK();
+  if (!loadConfiguration())
+  {
+    return (false);
+  }
   m_configuration.isSoftwareWriteProtect = true; // Set the software write protection bit
-  return updateConfigRegister();                 // Update the configuration register
+  return applyConfigChange();                    // Update the configuration register
 }
 
 /**
@@ -210,8 +564,13 @@ bool Mem24CSM01::enableSoftwareWriteProtect()
  */
 bool Mem24CSM01::disableSoftwareWriteProtect()
 {
+  MEM24CSM01_LOCK();
+  if (!loadConfiguration())
+  {
+    return (false);
+  }
   m_configuration.isSoftwareWriteProtect = false; // Clear the software write protection bit
-  return updateConfigRegister();                  // Update the configuration register
+  return applyConfigChange();                     // Update the configuration register
 }
 
 /**
@@ -225,11 +584,12 @@ bool Mem24CSM01::disableSoftwareWriteProtect()
  */
 bool Mem24CSM01::setWriteProtectionZone(uint8_t zone)
 {
-  if (zone >= 0 && zone <= 7)
+  MEM24CSM01_LOCK();
+  if (zone >= 0 && zone <= 7 && loadConfiguration())
   {
     uint8_t temp_zoneProtection = bitSet(m_configuration.zoneProtection, zone);
     m_configuration.zoneProtection = temp_zoneProtection;
-    if (updateConfigRegister())
+    if (applyConfigChange())
       return (true);
   }
 
@@ -247,8 +607,13 @@ bool Mem24CSM01::setWriteProtectionZone(uint8_t zone)
  */
 bool Mem24CSM01::writeProtection(uint8_t zones)
 {
+  MEM24CSM01_LOCK();
+  if (!loadConfiguration())
+  {
+    return (false);
+  }
   m_configuration.zoneProtection = zones;
-  return updateConfigRegister();
+  return applyConfigChange();
 }
 
 /**
@@ -262,11 +627,12 @@ bool Mem24CSM01::writeProtection(uint8_t zones)
  */
 bool Mem24CSM01::removeWriteProtectionZone(uint8_t zone)
 {
-  if (zone >= 0 && zone <= 7)
+  MEM24CSM01_LOCK();
+  if (zone >= 0 && zone <= 7 && loadConfiguration())
   {
     uint8_t temp_zoneProtection = bitClear(m_configuration.zoneProtection, zone);
     m_configuration.zoneProtection = temp_zoneProtection;
-    if (updateConfigRegister())
+    if (applyConfigChange())
       return (true);
   }
 
@@ -308,6 +674,7 @@ MEMORYRESULT Mem24CSM01::write(uint32_t address, uint8_t singleByte)
  * - MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT: The specified address exceeds the memory limits.
  * - MEMORYRESULT::BUFFER_TOO_LARGE: The size of the data block exceeds the maximum page size.
  * - MEMORYRESULT::NOT_ON_SINGLE_PAGE: The write operation spans across multiple memory pages.
+ * - MEMORYRESULT::WRITE_PROTECTED: The page is in a write protected zone, nothing has been sent.
  * - Other values indicating the result of the I2C transmission.
  */
 MEMORYRESULT Mem24CSM01::write(uint32_t address, uint8_t *dataArray, size_t arraySize)
@@ -320,160 +687,1823 @@ MEMORYRESULT Mem24CSM01::write(uint32_t address, uint8_t *dataArray, size_t arra
   {
     return (MEMORYRESULT::BUFFER_TOO_LARGE);
   }
-  if ((address + arraySize - 1) > 0xFF) // Check if the write operation is within a single page
+  if ((address % MAX_MEMORY_PAGE_SIZE) + arraySize > MAX_MEMORY_PAGE_SIZE) // Check if the write operation is within a single page
   {
     return (MEMORYRESULT::NOT_ON_SINGLE_PAGE);
   }
-
-  WriteAddressPacket writeAddressPacket = configureAddressPacket(address); //
-  Wire.beginTransmission(writeAddressPacket.deviceMemoryAddress);
-  Wire.write(writeAddressPacket.memoryMSB);
-  Wire.write(writeAddressPacket.memoryLSB);
-  for (unsigned int i = 0; i < arraySize; ++i)
+  if (protectedSize(address, arraySize) > 0) // The page is in a protected zone, the chip would ignore the data
   {
-    Wire.write(dataArray[i]);
+    return (MEMORYRESULT::WRITE_PROTECTED);
   }
 
-  int transmissionResult = Wire.endTransmission();
-  return (processTransmissionResult(transmissionResult));
+  return (writeBulk(address, dataArray, arraySize));
 }
 
 /**
- * @brief Reads a byte of data from the EEPROM at the current address pointer.
+ * @brief Writes a block of data of any size to the EEPROM memory.
  *
- * This function initiates a transmission to the EEPROM device, requests one byte
- * of data from the current address pointer, and stores the received byte in the
- * provided data buffer. The 24CSM01 contains an internal Address Pointer that
- * maintains the word address of the last byte accessed, internally incremented by
- * one. Therefore, if the previous read access was to address ‘n’ (n is any legal
- * address), the next current address read operation would access data from address ‘n+1’.
+ * The block is split on page boundaries so that every page is programmed with a single
+ * page write: a leading partial page, as many full pages as needed and a trailing partial
+ * page. This is the fewest write cycles (tWC) a block can take, e.g. 4 KiB written from an
+ * aligned address costs 16 write cycles.
+ * When the Wire transmit buffer is smaller than a page (32 bytes on AVR) every page is
+ * further split in chunks of MEM24CSM01_WRITE_CHUNK_SIZE bytes, each one with its own write cycle.
+ * Every page waits for the write cycle of the previous one with ACK polling, the last
+ * page write cycle is still running when the function returns.
  *
- * @param data Pointer to a buffer where the read byte will be stored.
- * @return MEMORYRESULT::OK if the read operation was successful.
- *         MEMORYRESULT::GENERIC_ERROR if the read operation failed.
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param dataArray A pointer to the array of data to be written to the EEPROM memory.
+ * @param arraySize The size of the data array, up to the full memory size.
+ * @return MEMORYRESULT The result of the write operation.
+ *
+ * Possible return values:
+ * - MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT: The specified address exceeds the memory limits.
+ * - MEMORYRESULT::BUFFER_TOO_LARGE: The data block does not fit between the address and the end of the memory.
+ * - MEMORYRESULT::WRITE_PROTECTED: Part of the block is in write protected zones, the rest has been written.
+ * - Other values indicating the result of the first failed I2C transmission.
  */
-MEMORYRESULT Mem24CSM01::read(uint8_t *data)
-{ // Read at current adress pointer
-  Wire.beginTransmission(m_dev_address_memory_access);
-  Wire.endTransmission();
-  if (Wire.requestFrom(m_dev_address_memory_access, (uint8_t)1) != 1)
+MEMORYRESULT Mem24CSM01::writeBulk(uint32_t address, const uint8_t *dataArray, size_t arraySize)
+{
+  WriteSegment segment = {dataArray, arraySize};
+  return (writev(address, &segment, 1));
+}
+
+/**
+ * @brief Writes a list of data blocks stored in different places to consecutive addresses.
+ *
+ * The segments are written as a single block, see writeBulk(): the bytes of all the segments
+ * sharing a page are sent with the same transaction straight from the segments, so a record
+ * made of a header, a payload and a trailer costs no copy buffer and no extra write cycle.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param segments The list of the blocks to write, in order.
+ * @param count The number of segments.
+ * @return MEMORYRESULT The result of the write operation, see writeBulk().
+ */
+MEMORYRESULT Mem24CSM01::writev(uint32_t address, const WriteSegment *segments, uint8_t count)
+{
+  MEM24CSM01_LOCK();
+  size_t arraySize = 0;
+  for (uint8_t i = 0; i < count; ++i)
   {
-    return (MEMORYRESULT::GENERIC_ERROR);
+    arraySize += segments[i].size;
   }
-  data[0] = Wire.read();
-  return (MEMORYRESULT::OK);
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (arraySize > MEMORY_SIZE - address) // Check if the block fits in the remaining memory
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  STATS_COUNT(writes, 1);
+
+  size_t written = 0;
+  bool skipped = false;
+  while (written < arraySize)
+  {
+    size_t protectedBytes = protectedSize(address, arraySize - written);
+    if (protectedBytes > 0) // Skip the protected zones without using the bus
+    {
+      address += protectedBytes;
+      written += protectedBytes;
+      skipped = true;
+      continue;
+    }
+    size_t chunkSize = writeChunkSize(address, arraySize - written);
+    MEMORYRESULT result = writeTransaction(address, segments, written, chunkSize);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address += chunkSize;
+    written += chunkSize;
+  }
+  return (skipped ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
 }
 
 /**
- * @brief Reads a single byte from the specified address in the EEPROM.
+ * @brief Writes a block of data skipping the bytes that already hold the same value.
  *
- * This function performs a random read operation from the EEPROM memory.
+ * The memory content is read first in chunks of MEM24CSM01_COMPARE_CHUNK_SIZE bytes and
+ * compared with the new data. For every page only the range from the first to the last
+ * different byte is written, pages already holding the data are not written at all.
+ * Reading a page costs much less than a write cycle, so this saves time and endurance
+ * whenever most of the data is unchanged, e.g. when a settings structure is saved.
  *
- * @param address The memory address to read from.
- * @param data Pointer to a variable where the read byte will be stored.
- * @return MEMORYRESULT::OK if the read operation is successful.
- *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the maximum allowed memory address.
- *         MEMORYRESULT::BUFFER_TOO_LARGE if the buffer size exceeds the maximum allowed size.
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param dataArray A pointer to the array of data to be written to the EEPROM memory.
+ * @param arraySize The size of the data array, up to the full memory size.
+ * @return MEMORYRESULT The result of the operation.
+ *
+ * Possible return values:
+ * - MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT: The specified address exceeds the memory limits.
+ * - MEMORYRESULT::BUFFER_TOO_LARGE: The data block does not fit between the address and the end of the memory.
+ * - MEMORYRESULT::WRITE_PROTECTED: Part of the block is in write protected zones, the rest has been updated.
+ * - Other values indicating the result of the first failed read or write.
  */
-MEMORYRESULT Mem24CSM01::read(uint32_t address, uint8_t *data)
-{ // Random read {
-  return (read(address, data, 1));
+MEMORYRESULT Mem24CSM01::update(uint32_t address, const uint8_t *dataArray, size_t arraySize)
+{
+  MEM24CSM01_LOCK();
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (arraySize > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  uint8_t current[MEM24CSM01_COMPARE_CHUNK_SIZE]; // Memory content being compared
+  bool skipped = false;
+  while (arraySize > 0)
+  {
+    size_t protectedBytes = protectedSize(address, arraySize);
+    if (protectedBytes > 0) // The protected zones are neither compared nor written
+    {
+      address += protectedBytes;
+      dataArray += protectedBytes;
+      arraySize -= protectedBytes;
+      skipped = true;
+      continue;
+    }
+    size_t pageSize = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE); // Bytes of the block in this page
+    if (pageSize > arraySize)
+    {
+      pageSize = arraySize;
+    }
+
+    size_t first = pageSize; // Offset of the first different byte
+    size_t last = 0;         // Offset after the last different byte
+    for (size_t offset = 0; offset < pageSize; offset += MEM24CSM01_COMPARE_CHUNK_SIZE)
+    {
+      size_t chunkSize = pageSize - offset;
+      if (chunkSize > MEM24CSM01_COMPARE_CHUNK_SIZE)
+      {
+        chunkSize = MEM24CSM01_COMPARE_CHUNK_SIZE;
+      }
+      MEMORYRESULT result = read(address + offset, current, chunkSize);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      for (size_t i = 0; i < chunkSize; ++i)
+      {
+        if (current[i] != dataArray[offset + i])
+        {
+          if (first == pageSize)
+          {
+            first = offset + i;
+          }
+          last = offset + i + 1;
+        }
+      }
+    }
+
+    if (first < last) // Write only the changed range of the page
+    {
+      MEMORYRESULT result = writeBulk(address + first, dataArray + first, last - first);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+    }
+    address += pageSize;
+    dataArray += pageSize;
+    arraySize -= pageSize;
+  }
+  return (skipped ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
 }
 
 /**
- * @brief Reads data from the memory at the specified address into the provided buffer.
+ * @brief Writes a block of data compared with the content already stored, without reading it.
  *
- * @param address The memory address to read from.
- * @param buffer Pointer to the buffer where the read data will be stored.
- * @param bufferSize The size of the buffer and the number of bytes to read.
- * @return MEMORYRESULT::OK if the read operation is successful.
- *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the maximum allowed memory address.
- *         MEMORYRESULT::BUFFER_TOO_LARGE if the buffer size exceeds the maximum allowed size.
+ * Same as update() when the caller keeps a copy of the stored data, e.g. the value read at
+ * startup: for every page only the range from the first to the last different byte is written.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param dataArray A pointer to the new data.
+ * @param previous A pointer to the data currently stored at the address.
+ * @param arraySize The size of the data, up to the full memory size.
+ * @return MEMORYRESULT The result of the operation, see update().
  */
-MEMORYRESULT Mem24CSM01::read(uint32_t address, uint8_t *buffer, size_t bufferSize)
+MEMORYRESULT Mem24CSM01::updateFrom(uint32_t address, const uint8_t *dataArray, const uint8_t *previous, size_t arraySize)
 {
   if (address > MAX_MEMORY_ADDRESS_VALUE)
   {
     return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
   }
-  if (bufferSize > 256)
+  if (arraySize > MEMORY_SIZE - address)
   {
     return (MEMORYRESULT::BUFFER_TOO_LARGE);
   }
-  uint8_t deviceAddress = addressMemoryPointer(address);
-  Wire.endTransmission();
-  Wire.requestFrom(deviceAddress, bufferSize);
-  size_t i = 0;
-  while (Wire.available())
+
+  bool skipped = false;
+  while (arraySize > 0)
   {
-    buffer[i] = Wire.read();
-    ++i;
+    size_t pageSize = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE); // Bytes of the block in this page
+    if (pageSize > arraySize)
+    {
+      pageSize = arraySize;
+    }
+    size_t first = 0; // Offset of the first different byte
+    while (first < pageSize && dataArray[first] == previous[first])
+    {
+      first++;
+    }
+    size_t last = pageSize; // Offset after the last different byte
+    while (last > first && dataArray[last - 1] == previous[last - 1])
+    {
+      last--;
+    }
+    if (first < last) // Write only the changed range of the page
+    {
+      MEMORYRESULT result = writeBulk(address + first, dataArray + first, last - first);
+      if (result == MEMORYRESULT::WRITE_PROTECTED)
+      {
+        skipped = true;
+      }
+      else if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+    }
+    address += pageSize;
+    dataArray += pageSize;
+    previous += pageSize;
+    arraySize -= pageSize;
   }
-  return (MEMORYRESULT::OK);
+  return (skipped ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
 }
 
 /**
- * @brief Configures a WriteAddressPacket with the given address.
- *
- * This function takes a 24-bit address and splits it into three parts:
- * - The device memory address, which includes the 17th bit of the address.
- * - The most significant byte (MSB) of the address.
- * - The least significant byte (LSB) of the address.
+ * @brief Writes the same byte in a range of the memory.
  *
- * @param address The 24-bit address to be configured into the WriteAddressPacket.
- * @return WriteAddressPacket The configured WriteAddressPacket containing the device memory address, MSB, and LSB.
+ * @param address The first address of the range.
+ * @param value The byte written in the whole range.
+ * @param size The size of the range, up to the full memory size.
+ * @return MEMORYRESULT The result of the operation, see fill(address, pattern, patternSize, size).
  */
-WriteAddressPacket Mem24CSM01::configureAddressPacket(uint32_t address)
+MEMORYRESULT Mem24CSM01::fill(uint32_t address, uint8_t value, size_t size)
 {
-  WriteAddressPacket writeAddressPacket;
-  uint8_t highAddrBit = (address >> 17) & 1;                                                 // Extract the 17th bit of the address
-  writeAddressPacket.deviceMemoryAddress = m_dev_address_memory_access | (highAddrBit << 1); // Set the device address in the right position
-  writeAddressPacket.memoryMSB = (address >> 8) & 0xFF;                                      // Extract the most significant byte of the address
-  writeAddressPacket.memoryLSB = address & 0xFF;                                             // Extract the least significant byte of the address
-  return (writeAddressPacket);
+  return (fill(address, &value, 1, size));
 }
 
 /**
- * @brief Processes the result of a transmission and returns the corresponding MEMORYRESULT.
+ * @brief Writes a repeated pattern in a range of the memory.
  *
- * This function takes an integer representing the result of a transmission and maps it to a MEMORYRESULT
- * enumeration value. The mapping is as follows:
- * - 0: MEMORYRESULT::OK
- * - 2: MEMORYRESULT::ADDRESS_ERROR
- * - 3: MEMORYRESULT::DATA_ERROR
- * - 5: MEMORYRESULT::TIMEOUT
- * - Any other value: MEMORYRESULT::GENERIC_ERROR
+ * The pattern is copied a whole number of times in a stack buffer of MEM24CSM01_FILL_BLOCK_SIZE
+ * bytes, every page is then sent as a list of segments pointing into that buffer, so a full
+ * page is written with one write cycle without a page sized buffer (one cycle per
+ * MEM24CSM01_WRITE_CHUNK_SIZE bytes when the Wire buffer is smaller than a page).
+ * The first byte of the range receives the first byte of the pattern, the last repetition
+ * is cut at the end of the range. The protected zones are skipped.
  *
- * @param transmissionResult The result of the transmission as an integer.
- * @return MEMORYRESULT The corresponding MEMORYRESULT enumeration value.
+ * @param address The first address of the range.
+ * @param pattern The bytes repeated over the range.
+ * @param patternSize The size of the pattern, from 1 to MEM24CSM01_FILL_BLOCK_SIZE.
+ * @param size The size of the range, up to the full memory size.
+ * @return MEMORYRESULT The result of the operation.
+ *
+ * Possible return values:
+ * - MEMORYRESULT::OK: The whole range has been written.
+ * - MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT: The specified address exceeds the memory limits.
+ * - MEMORYRESULT::BUFFER_TOO_LARGE: The range does not fit in the memory or the pattern size is not valid.
+ * - MEMORYRESULT::WRITE_PROTECTED: Part of the range is in write protected zones, the rest has been written.
+ * - Other values indicating the result of the first failed write.
  */
-MEMORYRESULT Mem24CSM01::processTransmissionResult(int transmissionResult)
+MEMORYRESULT Mem24CSM01::fill(uint32_t address, const uint8_t *pattern, uint8_t patternSize, size_t size)
 {
-  switch (transmissionResult)
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
   {
-  case 0:
-    return (MEMORYRESULT::OK);
-    break;
-  case 2:
-    return (MEMORYRESULT::ADDRESS_ERROR);
-    break;
-  case 3:
-    return (MEMORYRESULT::DATA_ERROR);
-    break;
-  case 5:
-    return (MEMORYRESULT::TIMEOUT);
-    break;
-  default:
-    return (MEMORYRESULT::GENERIC_ERROR);
-    break;
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > MEMORY_SIZE - address || patternSize == 0 || patternSize > MEM24CSM01_FILL_BLOCK_SIZE)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  uint8_t block[MEM24CSM01_FILL_BLOCK_SIZE];                                   // Whole repetitions of the pattern
+  size_t blockSize = (MEM24CSM01_FILL_BLOCK_SIZE / patternSize) * patternSize; // At least half the buffer
+  for (size_t i = 0; i < blockSize; ++i)
+  {
+    block[i] = pattern[i % patternSize];
   }
+  WriteSegment segments[MAX_MEMORY_PAGE_SIZE / ((MEM24CSM01_FILL_BLOCK_SIZE + 1) / 2) + 2];
+  size_t phase = 0; // Position in the block of the next byte to write
+  bool skipped = false;
+  while (size > 0)
+  {
+    size_t protectedBytes = protectedSize(address, size);
+    if (protectedBytes > 0)
+    {
+      address += protectedBytes;
+      size -= protectedBytes;
+      phase = (phase + protectedBytes) % blockSize;
+      skipped = true;
+      continue;
+    }
+    size_t pageSize = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE); // Bytes of the range in this page
+    if (pageSize > size)
+    {
+      pageSize = size;
+    }
+    uint8_t count = 0;
+    for (size_t built = 0; built < pageSize; ++count)
+    {
+      size_t segmentSize = blockSize - phase;
+      if (segmentSize > pageSize - built)
+      {
+        segmentSize = pageSize - built;
+      }
+      segments[count].data = block + phase;
+      segments[count].size = segmentSize;
+      built += segmentSize;
+      phase = (phase + segmentSize) % blockSize;
+    }
+    MEMORYRESULT result = writev(address, segments, count);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address += pageSize;
+    size -= pageSize;
+  }
+  return (skipped ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
 }
 
-uint8_t Mem24CSM01::addressMemoryPointer(uint32_t address)
-{
+/**
+ * @brief Erases a software write protection zone, every byte is set to ERASED_VALUE.
+ *
+ * @param zone The zone to erase, from 0 to 7.
+ * @return MEMORYRESULT ADDRESS_EXCEEDS_LIMIT if the zone does not exist, otherwise the result of fill().
+ */
+MEMORYRESULT Mem24CSM01::erase(uint8_t zone)
+{
+  if (zone >= MEMORY_SIZE / ZONE_SIZE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  return (fill((uint32_t)zone * ZONE_SIZE, ERASED_VALUE, ZONE_SIZE));
+}
+
+/**
+ * @brief Erases the whole memory, every byte is set to ERASED_VALUE.
+ *
+ * The 512 pages take one write cycle each when the Wire buffer holds a full page.
+ *
+ * @return MEMORYRESULT The result of fill().
+ */
+MEMORYRESULT Mem24CSM01::erase()
+{
+  return (fill(0, ERASED_VALUE, MEMORY_SIZE));
+}
+
+/**
+ * @brief Compares a range of the memory with a buffer.
+ *
+ * The memory is read in chunks of MEM24CSM01_COMPARE_CHUNK_SIZE bytes, the comparison stops
+ * at the first different byte.
+ *
+ * @param address The first address of the range.
+ * @param data The expected content of the range.
+ * @param size The size of the range.
+ * @param mismatchAddress Optional pointer where the address of the first different byte is stored.
+ * @return MEMORYRESULT OK if the range holds the data, MISMATCH if a byte is different,
+ *         otherwise the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01::compare(uint32_t address, const uint8_t *data, size_t size, uint32_t *mismatchAddress)
+{
+  return (comparePattern(address, data, size, size, mismatchAddress));
+}
+
+/**
+ * @brief Checks that every byte of a range holds the same value, e.g. that a zone is erased.
+ *
+ * @param address The first address of the range.
+ * @param value The expected value of every byte.
+ * @param size The size of the range.
+ * @param mismatchAddress Optional pointer where the address of the first different byte is stored.
+ * @return MEMORYRESULT The result of the comparison, see compare().
+ */
+MEMORYRESULT Mem24CSM01::verifyFill(uint32_t address, uint8_t value, size_t size, uint32_t *mismatchAddress)
+{
+  return (comparePattern(address, &value, 1, size, mismatchAddress));
+}
+
+/**
+ * @brief Compares a range of the memory with a repeated pattern.
+ *
+ * @param address The first address of the range.
+ * @param pattern The expected bytes, repeated over the range.
+ * @param patternSize The size of the pattern, not 0 unless size is 0.
+ * @param size The size of the range.
+ * @param mismatchAddress Optional pointer where the address of the first different byte is stored.
+ * @return MEMORYRESULT The result of the comparison, see compare().
+ */
+MEMORYRESULT Mem24CSM01::comparePattern(uint32_t address, const uint8_t *pattern, size_t patternSize, size_t size, uint32_t *mismatchAddress)
+{
+  MEM24CSM01_LOCK();
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  uint8_t current[MEM24CSM01_COMPARE_CHUNK_SIZE]; // Memory content being compared
+  size_t position = 0;                            // Position in the pattern of the next byte
+  while (size > 0)
+  {
+    size_t chunkSize = size;
+    if (chunkSize > MEM24CSM01_COMPARE_CHUNK_SIZE)
+    {
+      chunkSize = MEM24CSM01_COMPARE_CHUNK_SIZE;
+    }
+    MEMORYRESULT result = read(address, current, chunkSize); // The next chunks start at the address pointer
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    for (size_t i = 0; i < chunkSize; ++i)
+    {
+      if (current[i] != pattern[position])
+      {
+        if (mismatchAddress != nullptr)
+        {
+          *mismatchAddress = address + i;
+        }
+        return (MEMORYRESULT::MISMATCH);
+      }
+      if (++position == patternSize)
+      {
+        position = 0;
+      }
+    }
+    address += chunkSize;
+    size -= chunkSize;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes a block of data followed by its CRC.
+ *
+ * The CRC is written in the same transaction as the end of the data, so a write interrupted
+ * by a reset or corrupted on the bus is detected by readChecked(). The block takes arraySize + Mem24CSM01Crc::size(type)
+ * bytes of memory.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param dataArray A pointer to the array of data to be written to the EEPROM memory.
+ * @param arraySize The size of the data array.
+ * @param type The CRC appended to the data.
+ * @return MEMORYRESULT The result of the write operation, see writeBulk().
+ */
+MEMORYRESULT Mem24CSM01::writeChecked(uint32_t address, const uint8_t *dataArray, size_t arraySize, CRCTYPE type)
+{
+  uint8_t crcSize = Mem24CSM01Crc::size(type);
+  if (address <= MAX_MEMORY_ADDRESS_VALUE && arraySize > MEMORY_SIZE - address - crcSize)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE); // Check the CRC fits too before writing the data
+  }
+  uint8_t crc[4];
+  Mem24CSM01Crc::store(type, Mem24CSM01Crc::compute(type, dataArray, arraySize), crc);
+  WriteSegment segments[2] = {{dataArray, arraySize}, {crc, crcSize}};
+  return (writev(address, segments, 2));
+}
+
+/**
+ * @brief Reads a block of data written by writeChecked() and verifies its CRC.
+ *
+ * @param address The starting address in the EEPROM memory of the block.
+ * @param buffer Pointer to the buffer where the data will be stored.
+ * @param size The size of the data, without the CRC.
+ * @param type The CRC appended to the data.
+ * @return MEMORYRESULT::OK if the data has been read and the CRC matches.
+ *         MEMORYRESULT::CRC_ERROR if the CRC does not match, the buffer holds the data read anyway.
+ *         Other values indicating the result of the failed read, see read().
+ */
+MEMORYRESULT Mem24CSM01::readChecked(uint32_t address, uint8_t *buffer, size_t size, CRCTYPE type)
+{
+  uint8_t crcSize = Mem24CSM01Crc::size(type);
+  if (address <= MAX_MEMORY_ADDRESS_VALUE && size > MEMORY_SIZE - address - crcSize)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  uint8_t crc[4];
+  ReadSegment segments[2] = {{buffer, size}, {crc, crcSize}};
+  MEMORYRESULT result = readv(address, segments, 2);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  if (Mem24CSM01Crc::load(type, crc) != Mem24CSM01Crc::compute(type, buffer, size))
+  {
+    return (MEMORYRESULT::CRC_ERROR);
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads a byte of data from the EEPROM at the current address pointer.
+ *
+ * This function initiates a transmission to the EEPROM device, requests one byte
+ * of data from the current address pointer, and stores the received byte in the
+ * provided data buffer. The 24CSM01 contains an internal Address Pointer that
+ * maintains the word address of the last byte accessed, internally incremented by
+ * one. Therefore, if the previous read access was to address ‘n’ (n is any legal
+ * address), the next current address read operation would access data from address ‘n+1’.
+ * The driver follows the pointer after its reads and writes and sends the A16 bit it holds.
+ * The reads by address use a current address read too when they start at the pointer.
+ *
+ * @param data Pointer to a buffer where the read byte will be stored.
+ * @return MEMORYRESULT::OK if the read operation was successful.
+ *         MEMORYRESULT::GENERIC_ERROR if the read operation failed.
+ */
+MEMORYRESULT Mem24CSM01::read(uint8_t *data)
+{ // Read at current adress pointer
+  MEM24CSM01_LOCK();
+  MEMORYRESULT result = waitForWriteCompletion();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  STATS_COUNT(reads, 1);
+  STATS_START();
+  uint32_t address = m_address_pointer;
+  uint8_t deviceAddress = m_dev_address_memory_access;
+  if (address != ADDRESS_POINTER_UNKNOWN)
+  {
+    deviceAddress = configureAddressPacket(address).deviceMemoryAddress; // Keep the A16 bit of the pointer
+  }
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN;
+  if (requestFrom(deviceAddress, 1) != 1)
+  {
+    STATS_RECORD(BUSOPERATION::BUS_READ, 0, 0, MEMORYRESULT::GENERIC_ERROR);
+    return (MEMORYRESULT::GENERIC_ERROR);
+  }
+  if (address != ADDRESS_POINTER_UNKNOWN)
+  {
+    m_address_pointer = (address + 1) & MAX_MEMORY_ADDRESS_VALUE; // The pointer rolls over at the end of the memory
+  }
+  data[0] = m_bus->read();
+  STATS_COUNT(bytesRead, 1);
+  STATS_RECORD(BUSOPERATION::BUS_READ, 0, 1, MEMORYRESULT::OK);
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads a single byte from the specified address in the EEPROM.
+ *
+ * This function performs a random read operation from the EEPROM memory.
+ *
+ * @param address The memory address to read from.
+ * @param data Pointer to a variable where the read byte will be stored.
+ * @return MEMORYRESULT::OK if the read operation is successful.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the maximum allowed memory address.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the buffer size exceeds the maximum allowed size.
+ */
+MEMORYRESULT Mem24CSM01::read(uint32_t address, uint8_t *data)
+{ // Random read {
+  return (read(address, data, 1));
+}
+
+/**
+ * @brief Reads data from the memory at the specified address into the provided buffer.
+ *
+ * The memory pointer is set once with the address, then the data is read with consecutive
+ * current address reads of MEM24CSM01_READ_CHUNK_SIZE bytes, so any length fitting in the
+ * memory can be read without exceeding the Wire receive buffer. The chip increments its
+ * internal address pointer after every byte, the address is sent again only when the
+ * read crosses the 64 KiB boundary selected by the A16 bit of the device address.
+ *
+ * @param address The memory address to read from.
+ * @param buffer Pointer to the buffer where the read data will be stored.
+ * @param bufferSize The size of the buffer and the number of bytes to read.
+ * @param bytesRead Optional pointer where the number of bytes actually read is stored.
+ * @return MEMORYRESULT::OK if the read operation is successful.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the maximum allowed memory address.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the read does not fit between the address and the end of the memory.
+ *         MEMORYRESULT::GENERIC_ERROR if the chip returned less bytes than requested.
+ *         Other values indicating the result of the I2C transmission of the address.
+ */
+MEMORYRESULT Mem24CSM01::read(uint32_t address, uint8_t *buffer, size_t bufferSize, size_t *bytesRead)
+{
+  ReadSegment segment = {buffer, bufferSize};
+  return (readv(address, &segment, 1, bytesRead));
+}
+
+/**
+ * @brief Reads consecutive addresses into a list of buffers stored in different places.
+ *
+ * The bytes are copied from the Wire buffer straight into the segments, the transactions
+ * are the same as for a single read() of the whole size.
+ *
+ * @param address The starting address in the EEPROM memory.
+ * @param segments The list of the buffers to fill, in order.
+ * @param count The number of segments.
+ * @param bytesRead Optional pointer where the number of bytes read is stored, also when an error occurs.
+ * @return MEMORYRESULT The result of the read operation, see read().
+ */
+MEMORYRESULT Mem24CSM01::readv(uint32_t address, const ReadSegment *segments, uint8_t count, size_t *bytesRead)
+{
+  MEM24CSM01_LOCK();
+  size_t bufferSize = 0;
+  for (uint8_t i = 0; i < count; ++i)
+  {
+    bufferSize += segments[i].size;
+  }
+  if (bytesRead != nullptr)
+  {
+    *bytesRead = 0;
+  }
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (bufferSize > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  MEMORYRESULT result = waitForWriteCompletion();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+
+  STATS_COUNT(reads, 1);
+  bool periodicCheck = false; // True when the ECS bit is checked after the last chunk of this read
+  if (m_ecc_interval != 0 && bufferSize > 0 && ++m_ecc_read_count >= m_ecc_interval)
+  {
+    m_ecc_read_count = 0;
+    periodicCheck = true;
+  }
+  size_t received = 0;
+  uint8_t deviceAddress = configureAddressPacket(address).deviceMemoryAddress;
+  size_t chunkSize = 0;
+  bool sample = false; // True when the ECS bit is checked after the chunk
+  size_t segmentOffset = 0; // Position in the current segment
+  uint8_t attempt = 0;
+  bool addressed = isPointerAt(address); // Current address read when the chip pointer is already there
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN; // Known again once the whole block has been read
+  while (received < bufferSize)
+  {
+    STATS_START();
+    if (!addressed || (address & 0xFFFF) == 0) // Set the memory pointer at start, at the A16 boundary and after a failure
+    {
+      deviceAddress = addressMemoryPointer(address);
+      result = processTransmissionResult(endTransmission());
+      if (result != MEMORYRESULT::OK)
+      {
+        STATS_RECORD(BUSOPERATION::BUS_READ, address, 0, result);
+        if (retryAfter(result, &attempt))
+        {
+          continue;
+        }
+        return (result);
+      }
+      addressed = true;
+    }
+
+    chunkSize = bufferSize - received;
+    if (chunkSize > MEM24CSM01_READ_CHUNK_SIZE)
+    {
+      chunkSize = MEM24CSM01_READ_CHUNK_SIZE;
+    }
+    size_t boundaryRemaining = 0x10000 - (address & 0xFFFF); // Bytes left before the A16 boundary
+    if (chunkSize > boundaryRemaining)
+    {
+      chunkSize = boundaryRemaining;
+    }
+    sample = (periodicCheck && received + chunkSize == bufferSize) || isEccSuspect(address, chunkSize);
+    if (sample) // The ECS bit does not tell which byte needed the correction, a sampled chunk covers a single page
+    {
+      size_t pageRemaining = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE);
+      if (chunkSize > pageRemaining)
+      {
+        chunkSize = pageRemaining;
+        sample = (periodicCheck && received + chunkSize == bufferSize) || isEccSuspect(address, chunkSize);
+      }
+    }
+
+    size_t available = requestFrom(deviceAddress, (uint8_t)chunkSize);
+    if (available > chunkSize)
+    {
+      available = chunkSize;
+    }
+    if (available != chunkSize && retryAfter(MEMORYRESULT::GENERIC_ERROR, &attempt))
+    {
+      STATS_RECORD(BUSOPERATION::BUS_READ, address, available, MEMORYRESULT::GENERIC_ERROR);
+      addressed = false; // Read the chunk again from its first byte
+      continue;
+    }
+    for (size_t i = 0; i < available; ++i)
+    {
+      while (segmentOffset == segments->size) // Move to the next non empty segment
+      {
+        segments++;
+        segmentOffset = 0;
+      }
+      segments->data[segmentOffset++] = m_bus->read();
+    }
+    STATS_COUNT(bytesRead, available);
+    STATS_RECORD(BUSOPERATION::BUS_READ, address, available, available == chunkSize ? MEMORYRESULT::OK : MEMORYRESULT::GENERIC_ERROR);
+    received += available;
+    address += available;
+    if (bytesRead != nullptr)
+    {
+      *bytesRead = received;
+    }
+    if (available != chunkSize)
+    {
+      return (MEMORYRESULT::GENERIC_ERROR);
+    }
+    retryAfter(MEMORYRESULT::OK, &attempt);
+    attempt = 0;
+    if (sample && received < bufferSize) // The ECS bit reflects only the last chunk read
+    {
+      sampleEcc(address - chunkSize);
+      addressed = false; // The register read moved the address pointer
+    }
+  }
+  m_address_pointer = address;
+  if (sample)
+  {
+    sampleEcc(address - chunkSize);
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the configuration register.
+ *
+ * @param value Pointer where the register value is stored.
+ * @return true if both bytes have been received, false otherwise.
+ */
+bool Mem24CSM01::readConfigRegister(uint16_t *value)
+{
+  if (waitForWriteCompletion() != MEMORYRESULT::OK) // The chip does not answer during a write cycle
+  {
+    return (false);
+  }
+  MEMORYRESULT result;
+  uint8_t attempt = 0;
+  do
+  {
+    STATS_START();
+    beginTransmission(m_dev_address_configuration_reg); // Start the transmission with the device
+    m_bus->write(CFGREG_WRD_ADDRH);                     // Write the first word address byte
+    m_bus->write(CFGREG_WRD_ADDRL);                     // Write the second word address byte
+    result = processTransmissionResult(endTransmission(false)); // Send a restart message to keep the bus open
+    if (result == MEMORYRESULT::OK && requestFrom(m_dev_address_configuration_reg, 2) != 2)
+    {
+      result = MEMORYRESULT::GENERIC_ERROR;
+    }
+    if (result == MEMORYRESULT::OK)
+    {
+      uint8_t high = m_bus->read(); // Read the first byte
+      uint8_t low = m_bus->read();  // Read the second byte
+      *value = (high << 8) | low;   // Concatenate the two bytes
+    }
+    STATS_RECORD(BUSOPERATION::BUS_CONFIGURATION, 0, 2, result);
+  } while (retryAfter(result, &attempt));
+  return (result == MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the configuration register into the local copy if it has not been read yet.
+ *
+ * The changes to the configuration start from the register content, so bits never read
+ * are not overwritten with the default values.
+ *
+ * @return true if the local copy is valid, false if the register could not be read.
+ */
+bool Mem24CSM01::loadConfiguration()
+{
+  if (!m_config_loaded)
+  {
+    getConfiguration();
+  }
+  return (m_config_loaded);
+}
+
+/**
+ * @brief Writes a configuration change, or defers it when a batch is open.
+ *
+ * @return true if the change has been written or deferred, false otherwise.
+ */
+bool Mem24CSM01::applyConfigChange()
+{
+  if (m_config_transaction)
+  {
+    return (true); // Written by commitConfig()
+  }
+  return (updateConfigRegister());
+}
+
+/**
+ * @brief Returns the number of bytes from an address covered by write protected zones.
+ *
+ * The zones are protected by the SWP bits only in Enhanced Software Write Protection Mode.
+ * The configuration register is read at the first call, then the copy of the register
+ * content is used, so a protected write is detected without any bus transaction.
+ * If the register cannot be read the write is left to the chip.
+ *
+ * @param address The first address to check.
+ * @param size The number of bytes to check.
+ * @return size_t The number of bytes from the address up to the first writable zone, 0 if the address is writable.
+ */
+size_t Mem24CSM01::protectedSize(uint32_t address, size_t size)
+{
+  if (!loadConfiguration() || !(m_config_value & EWPM_MASK))
+  {
+    return (0);
+  }
+  size_t protectedBytes = 0;
+  while (protectedBytes < size && (m_config_value & (1 << ((address + protectedBytes) / ZONE_SIZE))))
+  {
+    protectedBytes += ZONE_SIZE - ((address + protectedBytes) % ZONE_SIZE);
+  }
+  if (protectedBytes > size)
+  {
+    protectedBytes = size;
+  }
+  return (protectedBytes);
+}
+
+/**
+ * @brief Returns the writable bits of the configuration register built from the local copy.
+ *
+ * @return uint16_t The EWPM, LOCK and SWP bits.
+ */
+uint16_t Mem24CSM01::configValue()
+{
+  return ((m_configuration.isSoftwareWriteProtect ? EWPM_MASK : 0) | (m_configuration.isConfigLocked ? LOCK_MASK : 0) | m_configuration.zoneProtection);
+}
+
+/**
+ * @brief Reads a chunk of data into the Wire receive buffer without copying it.
+ *
+ * This is the building block of adapters like Mem24CSM01Stream: the bytes are then taken
+ * one at a time with readBuffered() straight from the Wire buffer. Any other transaction
+ * on the bus overwrites the buffer, compare getTransactionCount() with its value after
+ * this call to know whether the bytes are still there. The transactions made with the
+ * Wire library outside this library are not counted, code sharing the bus that way must
+ * not run between this call and the last readBuffered().
+ *
+ * @param address The address of the first byte.
+ * @param size The number of bytes wanted, the chunk is limited to MEM24CSM01_READ_CHUNK_SIZE
+ *             bytes and to the A16 boundary.
+ * @param received Pointer where the number of bytes available in the Wire buffer is stored.
+ * @return MEMORYRESULT The result of the read, see read().
+ */
+MEMORYRESULT Mem24CSM01::requestSequential(uint32_t address, size_t size, size_t *received)
+{
+  MEM24CSM01_LOCK();
+  *received = 0;
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  MEMORYRESULT result = waitForWriteCompletion();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  size_t chunkSize = size;
+  if (chunkSize > MEM24CSM01_READ_CHUNK_SIZE)
+  {
+    chunkSize = MEM24CSM01_READ_CHUNK_SIZE;
+  }
+  size_t boundaryRemaining = 0x10000 - (address & 0xFFFF); // Bytes left before the A16 boundary
+  if (chunkSize > boundaryRemaining)
+  {
+    chunkSize = boundaryRemaining;
+  }
+
+  STATS_START();
+  uint8_t deviceAddress = configureAddressPacket(address).deviceMemoryAddress;
+  if (!isPointerAt(address)) // Sequential chunks skip the address phase
+  {
+    addressMemoryPointer(address);
+    result = processTransmissionResult(endTransmission());
+  }
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN;
+  if (result == MEMORYRESULT::OK)
+  {
+    *received = requestFrom(deviceAddress, (uint8_t)chunkSize);
+    if (*received > chunkSize)
+    {
+      *received = chunkSize;
+    }
+    if (*received != chunkSize)
+    {
+      result = MEMORYRESULT::GENERIC_ERROR;
+    }
+    else
+    {
+      m_address_pointer = address + chunkSize;
+    }
+  }
+  STATS_COUNT(bytesRead, *received);
+  STATS_RECORD(BUSOPERATION::BUS_READ, address, *received, result);
+  return (result);
+}
+
+/**
+ * @brief Takes the next byte received by requestSequential() from the Wire buffer.
+ *
+ * @return int The byte, -1 if the buffer is empty.
+ */
+int Mem24CSM01::readBuffered()
+{
+  return (m_bus->read());
+}
+
+/**
+ * @brief Returns the next byte received by requestSequential() without taking it.
+ *
+ * @return int The byte, -1 if the buffer is empty.
+ */
+int Mem24CSM01::peekBuffered()
+{
+  return (m_bus->peek());
+}
+
+/**
+ * @brief Returns the number of transactions started on the bus of the chip.
+ *
+ * The counter is kept by the bus backend, so it includes the transactions of the other
+ * chips and drivers of the library using the same bus, see Mem24CSM01Backend::countTransaction().
+ *
+ * @return uint32_t The counter, it wraps around.
+ */
+uint32_t Mem24CSM01::getTransactionCount()
+{
+  return (m_bus->getTransactionCount());
+}
+
+/**
+ * @brief Returns the bus backend of the chip.
+ *
+ * The helpers built on the driver take the time from it, e.g. Mem24CSM01Batch, so they
+ * follow the virtual clock of Mem24CSM01Simulator like the driver does.
+ *
+ * @return Mem24CSM01Backend* The backend given to the constructor, or the Wire backend.
+ */
+Mem24CSM01Backend *Mem24CSM01::getBackend()
+{
+  return (m_bus);
+}
+
+/**
+ * @brief Sets the retries of the failed bus transactions.
+ *
+ * A failed transaction whose result is in the retry mask is repeated, up to maxAttempts
+ * attempts in total, after a delay of backoffMicros doubled at every retry. Only the
+ * failed page, read chunk or register access is repeated, not the whole operation.
+ * After busRecoveryThreshold consecutive TIMEOUT or GENERIC_ERROR results, the typical
+ * symptoms of a slave holding SDA low, the bus is recovered with recoverBus().
+ * The default policy makes a single attempt and never recovers the bus.
+ *
+ * @param policy The retry policy.
+ */
+void Mem24CSM01::setRetryPolicy(const RetryPolicy &policy)
+{
+  m_retry_policy = policy;
+  if (m_retry_policy.maxAttempts == 0)
+  {
+    m_retry_policy.maxAttempts = 1;
+  }
+  m_failure_count = 0;
+}
+
+/**
+ * @brief Sets the pins of the bus used by recoverBus().
+ *
+ * @param sdaPin The SDA pin, default is SDA.
+ * @param sclPin The SCL pin, default is SCL.
+ */
+void Mem24CSM01::setBusPins(uint8_t sdaPin, uint8_t sclPin)
+{
+  m_sda_pin = sdaPin;
+  m_scl_pin = sclPin;
+}
+
+/**
+ * @brief Frees the bus when a slave holds SDA low after an interrupted transaction.
+ *
+ * The Wire peripheral is released, SCL is clocked up to 9 times until the slave releases
+ * SDA, a stop condition is generated and the Wire library is initialized again with
+ * the clock given to begin(), without reading the chip. The lines are driven low or left to the pull-up resistors,
+ * never driven high.
+ *
+ * @return true if SDA is high after the recovery, false otherwise.
+ */
+bool Mem24CSM01::recoverBus()
+{
+  MEM24CSM01_LOCK();
+  STATS_COUNT(busRecoveries, 1);
+  m_bus->end();
+  pinMode(m_sda_pin, INPUT_PULLUP);
+  pinMode(m_scl_pin, INPUT_PULLUP);
+  for (uint8_t i = 0; i < 9 && digitalRead(m_sda_pin) == LOW; ++i)
+  {
+    pinMode(m_scl_pin, OUTPUT); // Clock low
+    digitalWrite(m_scl_pin, LOW);
+    delayMicroseconds(5);
+    pinMode(m_scl_pin, INPUT_PULLUP); // Clock released
+    delayMicroseconds(5);
+  }
+  pinMode(m_sda_pin, OUTPUT); // Stop condition: SDA rises while SCL is high
+  digitalWrite(m_sda_pin, LOW);
+  delayMicroseconds(5);
+  pinMode(m_sda_pin, INPUT_PULLUP);
+  delayMicroseconds(5);
+  bool released = digitalRead(m_sda_pin) == HIGH;
+  m_bus_held = false;
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN;
+  m_bus->begin(); // Only the bus: begin() reads the identity and its retries could recover the bus again
+  if (m_clock != 0)
+  {
+    m_bus->setClock(m_clock);
+  }
+  return (released);
+}
+
+/**
+ * @brief Applies the retry policy to the result of a bus transaction.
+ *
+ * @param result The result of the transaction.
+ * @param attempt Pointer to the number of attempts already failed, incremented on failure.
+ * @return true if the transaction has to be repeated, after the backoff delay.
+ */
+bool Mem24CSM01::retryAfter(MEMORYRESULT result, uint8_t *attempt)
+{
+  if (result == MEMORYRESULT::OK)
+  {
+    m_failure_count = 0;
+    return (false);
+  }
+  if (result == MEMORYRESULT::TIMEOUT || result == MEMORYRESULT::GENERIC_ERROR)
+  {
+    if (m_failure_count < 0xFF)
+    {
+      m_failure_count++;
+    }
+    if (m_retry_policy.busRecoveryThreshold != 0 && m_failure_count >= m_retry_policy.busRecoveryThreshold)
+    {
+      m_failure_count = 0;
+      recoverBus();
+    }
+  }
+  (*attempt)++;
+  if (*attempt >= m_retry_policy.maxAttempts || !(m_retry_policy.retryMask & RETRY_ON(result)))
+  {
+    return (false);
+  }
+  STATS_COUNT(retries, 1);
+  uint8_t doublings = *attempt - 1;
+  if (doublings > 8)
+  {
+    doublings = 8;
+  }
+  m_bus->delayMicros((uint32_t)m_retry_policy.backoffMicros << doublings);
+  return (true);
+}
+
+/**
+ * @brief Configures a WriteAddressPacket with the given address.
+ *
+ * This function takes a 24-bit address and splits it into three parts:
+ * - The device memory address, which includes the 17th bit of the address.
+ * - The most significant byte (MSB) of the address.
+ * - The least significant byte (LSB) of the address.
+ *
+ * @param address The 24-bit address to be configured into the WriteAddressPacket.
+ * @return WriteAddressPacket The configured WriteAddressPacket containing the device memory address, MSB, and LSB.
+ */
+WriteAddressPacket Mem24CSM01::configureAddressPacket(uint32_t address)
+{
+  WriteAddressPacket writeAddressPacket;
+  uint8_t highAddrBit = (address >> 16) & 1;                                          // Extract the 17th bit (A16) of the address
+  writeAddressPacket.deviceMemoryAddress = m_dev_address_memory_access | highAddrBit; // Set the device address in the right position
+  writeAddressPacket.memoryMSB = (address >> 8) & 0xFF;                                      // Extract the most significant byte of the address
+  writeAddressPacket.memoryLSB = address & 0xFF;                                             // Extract the least significant byte of the address
+  return (writeAddressPacket);
+}
+
+/**
+ * @brief Processes the result of a transmission and returns the corresponding MEMORYRESULT.
+ *
+ * This function takes an integer representing the result of a transmission and maps it to a MEMORYRESULT
+ * enumeration value. The mapping is as follows:
+ * - 0: MEMORYRESULT::OK
+ * - 2: MEMORYRESULT::ADDRESS_ERROR
+ * - 3: MEMORYRESULT::DATA_ERROR
+ * - 5: MEMORYRESULT::TIMEOUT
+ * - Any other value: MEMORYRESULT::GENERIC_ERROR
+ * The mapping is done by transmissionToMemoryResult(), shared with Mem24CSM01T.
+ *
+ * @param transmissionResult The result of the transmission as an integer.
+ * @return MEMORYRESULT The corresponding MEMORYRESULT enumeration value.
+ */
+MEMORYRESULT Mem24CSM01::processTransmissionResult(int transmissionResult)
+{
+  MEMORYRESULT result = transmissionToMemoryResult(transmissionResult);
+  STATS_COUNT(transmissionResults[result], 1);
+  return (result);
+}
+
+uint8_t Mem24CSM01::addressMemoryPointer(uint32_t address)
+{
+  WriteAddressPacket writeAddressPacket = configureAddressPacket(address);
+  beginTransmission(writeAddressPacket.deviceMemoryAddress);
+  m_bus->write(writeAddressPacket.memoryMSB);
+  m_bus->write(writeAddressPacket.memoryLSB);
+  return (writeAddressPacket.deviceMemoryAddress);
+}
+
+/**
+ * @brief Tells whether a read can start with a current address read.
+ *
+ * The chip keeps the address following the last byte read or written, the driver follows it
+ * in m_address_pointer. A read starting there skips the address phase (3 bytes on the bus).
+ * The A16 boundary is always addressed explicitly, like the reads crossing it.
+ *
+ * @param address The address of the first byte to read.
+ * @return true if the chip address pointer is known to be at the address.
+ */
+bool Mem24CSM01::isPointerAt(uint32_t address)
+{
+  return (address == m_address_pointer && (address & 0xFFFF) != 0);
+}
+
+/**
+ * @brief Updates the address pointer shadow after a page write.
+ *
+ * The chip increments the pointer for every byte received and wraps it around inside the page.
+ *
+ * @param address The address of the first byte written.
+ * @param size The number of bytes written.
+ */
+void Mem24CSM01::followWrite(uint32_t address, size_t size)
+{
+  m_address_pointer = (address & ~(uint32_t)(MAX_MEMORY_PAGE_SIZE - 1)) | ((address + size) & (MAX_MEMORY_PAGE_SIZE - 1));
+}
+
+/**
+ * @brief Writes up to one page of data in a single I2C transmission.
+ *
+ * The caller must ensure that the address is valid, that the data does not cross a page boundary,
+ * otherwise the chip internal address wraps around to the beginning of the page, and that
+ * the data fits in the Wire transmit buffer together with the two address bytes.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param segments The list of the blocks holding the data.
+ * @param offset The position of the first byte to write in the concatenation of the segments.
+ * @param arraySize The number of bytes to write.
+ * @return MEMORYRESULT::WIRE_BUFFER_OVERFLOW if the Wire buffer did not accept all the bytes,
+ *         otherwise the result of the I2C transmission.
+ */
+MEMORYRESULT Mem24CSM01::writeTransaction(uint32_t address, const WriteSegment *segments, size_t offset, size_t arraySize)
+{
+  MEMORYRESULT result = waitForWriteCompletion(); // Wait for the previous write cycle, if any
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+
+  m_address_pointer = ADDRESS_POINTER_UNKNOWN; // A failed transaction leaves it anywhere in the page
+  uint8_t attempt = 0;
+  do
+  {
+    STATS_START();
+    size_t queued = queueWrite(address, segments, offset, arraySize);
+    int transmissionResult = endTransmission(); // Always end the transmission to release the bus
+    result = processTransmissionResult(transmissionResult);
+    if (result == MEMORYRESULT::OK)
+    {
+      m_write_in_progress = true; // The chip starts the internal write cycle after the stop condition
+      m_write_cycle_start = m_bus->getMicros();
+      STATS_COUNT(pageWrites, 1);
+      STATS_COUNT(bytesWritten, queued - 2);
+    }
+    if (queued != arraySize + 2)
+    {
+      result = MEMORYRESULT::WIRE_BUFFER_OVERFLOW; // Only the first bytes have been transmitted
+    }
+    STATS_RECORD(BUSOPERATION::BUS_WRITE, address, arraySize, result);
+  } while (retryAfter(result, &attempt));
+  if (result == MEMORYRESULT::OK)
+  {
+    followWrite(address, arraySize);
+  }
+  return (result);
+}
+
+/**
+ * @brief Starts a write transmission and queues the address and the data bytes.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param segments The list of the blocks holding the data.
+ * @param offset The position of the first byte to write in the concatenation of the segments.
+ * @param arraySize The number of bytes to write.
+ * @return size_t The number of bytes accepted by the bus, address bytes included.
+ */
+size_t Mem24CSM01::queueWrite(uint32_t address, const WriteSegment *segments, size_t offset, size_t arraySize)
+{
+  while (offset >= segments->size) // Find the segment holding the first byte
+  {
+    offset -= segments->size;
+    segments++;
+  }
   WriteAddressPacket writeAddressPacket = configureAddressPacket(address);
-  Wire.beginTransmission(writeAddressPacket.deviceMemoryAddress);
-  Wire.write(writeAddressPacket.memoryMSB);
-  Wire.write(writeAddressPacket.memoryLSB);
-  return (writeAddressPacket.deviceMemoryAddress);
-}
\ No newline at end of file
+  beginTransmission(writeAddressPacket.deviceMemoryAddress);
+  size_t queued = m_bus->write(writeAddressPacket.memoryMSB);
+  queued += m_bus->write(writeAddressPacket.memoryLSB);
+  while (arraySize > 0)
+  {
+    size_t segmentBytes = segments->size - offset;
+    if (segmentBytes > arraySize)
+    {
+      segmentBytes = arraySize;
+    }
+    queued += m_bus->write(segments->data + offset, segmentBytes);
+    arraySize -= segmentBytes;
+    offset = 0;
+    segments++;
+  }
+  return (queued);
+}
+
+/**
+ * @brief Computes the size of the next write transaction.
+ *
+ * The transaction must not cross a page boundary and must fit in the Wire transmit buffer.
+ *
+ * @param address The address where the transaction starts.
+ * @param remaining The number of bytes left to write.
+ * @return size_t The number of bytes to send with the next transaction.
+ */
+size_t Mem24CSM01::writeChunkSize(uint32_t address, size_t remaining)
+{
+  size_t chunkSize = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE); // Bytes left before the next page boundary
+  if (chunkSize > MEM24CSM01_WRITE_CHUNK_SIZE)
+  {
+    chunkSize = MEM24CSM01_WRITE_CHUNK_SIZE;
+  }
+  if (chunkSize > remaining)
+  {
+    chunkSize = remaining;
+  }
+  return (chunkSize);
+}
+
+/**
+ * @brief Waits for the end of the internal write cycle using ACK polling.
+ *
+ * During the internal write cycle (tWC) the chip does not acknowledge its device address.
+ * This function sends empty transmissions to the memory device address and returns as
+ * soon as the chip acknowledges, which is usually well before the worst case write cycle time.
+ * No bus traffic is generated if no write was issued since the last completed poll.
+ * With MEM24CSM01_ENABLE_RTOS the bus lock is released between two polls, so the other
+ * tasks use the bus during the write cycle.
+ *
+ * @return MEMORYRESULT::OK if the chip is ready.
+ *         MEMORYRESULT::TIMEOUT if the chip did not acknowledge within the write timeout.
+ */
+MEMORYRESULT Mem24CSM01::waitForWriteCompletion()
+{
+  MEM24CSM01_LOCK();
+  unsigned long start = m_bus->getMillis();
+  unsigned long cycleStart = m_write_cycle_start;
+  while (isWriteInProgress())
+  {
+    if (m_write_cycle_start != cycleStart) // Another task started a write cycle during the yield
+    {
+      cycleStart = m_write_cycle_start;
+      start = m_bus->getMillis();
+    }
+    if (m_bus->getMillis() - start >= m_write_timeout)
+    {
+      return (MEMORYRESULT::TIMEOUT);
+    }
+    MEM24CSM01_YIELD();
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Checks once whether the internal write cycle is still running.
+ *
+ * The device address is polled with a single empty transmission, the chip acknowledges
+ * it only when the write cycle is over.
+ *
+ * @return true if a write cycle is running, false if the chip is ready.
+ */
+bool Mem24CSM01::isWriteInProgress()
+{
+  MEM24CSM01_LOCK();
+  if (!m_write_in_progress)
+  {
+    return (false);
+  }
+  STATS_START();
+  beginTransmission(m_dev_address_memory_access);
+  if (endTransmission() == 0) // The chip acknowledged, the write cycle is over
+  {
+    m_write_in_progress = false;
+  }
+  STATS_COUNT(ackPolls, 1);
+  STATS_RECORD(BUSOPERATION::BUS_ACK_POLL, 0, 0, m_write_in_progress ? MEMORYRESULT::BUSY : MEMORYRESULT::OK);
+  return (m_write_in_progress);
+}
+
+/**
+ * @brief Sets the maximum time to wait for the end of a write cycle.
+ *
+ * @param timeout The timeout in milliseconds, the default value is WRITE_CYCLE_TIMEOUT.
+ */
+void Mem24CSM01::setWriteTimeout(uint16_t timeout)
+{
+  m_write_timeout = timeout;
+}
+
+/**
+ * @brief Tells if the write cycle started by the last write may still be running, without using the bus.
+ *
+ * The answer is based on the maximum write cycle time: after WRITE_CYCLE_TIME
+ * milliseconds the chip is done even if isWriteInProgress() has not polled it yet.
+ * The chip often finishes earlier, isWriteInProgress() gives the exact state.
+ *
+ * @return true if a write cycle started less than WRITE_CYCLE_TIME milliseconds ago and has not been seen finished.
+ */
+bool Mem24CSM01::isWriteCycleActive()
+{
+  return (getWriteCycleRemaining() > 0);
+}
+
+/**
+ * @brief Returns the time left before the running write cycle is over in the worst case, without using the bus.
+ *
+ * The MCU can sleep for this time instead of polling the chip during tWC, the next
+ * access then finds the chip ready at the first attempt.
+ *
+ * @return The microseconds left of the maximum write cycle time, 0 if no write cycle is running.
+ */
+uint32_t Mem24CSM01::getWriteCycleRemaining()
+{
+  if (!m_write_in_progress)
+  {
+    return (0);
+  }
+  unsigned long elapsed = m_bus->getMicros() - m_write_cycle_start;
+  if (elapsed >= (unsigned long)WRITE_CYCLE_TIME * 1000)
+  {
+    return (0);
+  }
+  return ((unsigned long)WRITE_CYCLE_TIME * 1000 - elapsed);
+}
+
+/**
+ * @brief Enables the sampling of the ECS bit after the reads.
+ *
+ * The ECS bit of the configuration register reports whether the previous read operation
+ * needed the error correction, checking it costs a configuration register read. Instead of
+ * checking after every read, the check is done after one read every everyReads reads and
+ * after every chunk read from a suspect zone. The sampled chunks are split on page
+ * boundaries, so the page of every read needing the correction is known and recorded in a
+ * table of MEM24CSM01_ECC_TABLE_SIZE entries, see getEccEvents().
+ * The reads that are not sampled are not checked, so a sparse sampling gives a statistical
+ * picture of the failing pages rather than a complete one.
+ *
+ * @param everyReads Check one read every everyReads reads, 0 disables the periodic check.
+ * @param suspectZones Bitmask of the 16 KiB zones checked after every read, like zoneProtection().
+ */
+void Mem24CSM01::setEccSampling(uint16_t everyReads, uint8_t suspectZones)
+{
+  m_ecc_interval = everyReads;
+  m_ecc_suspect_zones = suspectZones;
+  m_ecc_read_count = 0;
+}
+
+/**
+ * @brief Returns the pages where the error correction has been needed.
+ *
+ * @param count Pointer where the number of entries of the table is stored.
+ * @return const EccEvent* The table of the pages, ordered by first detection.
+ */
+const EccEvent *Mem24CSM01::getEccEvents(uint8_t *count)
+{
+  *count = m_ecc_event_count;
+  return (m_ecc_events);
+}
+
+/**
+ * @brief Returns the number of corrections not recorded because the table was full.
+ *
+ * @return uint16_t The number of lost events since the last clearEccEvents().
+ */
+uint16_t Mem24CSM01::getEccEventsLost()
+{
+  return (m_ecc_events_lost);
+}
+
+/**
+ * @brief Empties the table of the pages where the error correction has been needed.
+ */
+void Mem24CSM01::clearEccEvents()
+{
+  m_ecc_event_count = 0;
+  m_ecc_events_lost = 0;
+}
+
+/**
+ * @brief Checks whether a range touches one of the zones sampled after every read.
+ *
+ * @param address The first address of the range.
+ * @param size The size of the range.
+ * @return true if the range touches a suspect zone set by setEccSampling().
+ */
+bool Mem24CSM01::isEccSuspect(uint32_t address, size_t size)
+{
+  if (m_ecc_suspect_zones == 0 || size == 0)
+  {
+    return (false);
+  }
+  uint8_t firstZone = address / ZONE_SIZE;
+  uint8_t lastZone = (address + size - 1) / ZONE_SIZE;
+  for (uint8_t zone = firstZone; zone <= lastZone; ++zone)
+  {
+    if (m_ecc_suspect_zones & (1 << zone))
+    {
+      return (true);
+    }
+  }
+  return (false);
+}
+
+/**
+ * @brief Checks the ECS bit after a sampled chunk and records its page when the correction was needed.
+ *
+ * @param address The address of the chunk just read, the chunk must not cross a page boundary.
+ */
+void Mem24CSM01::sampleEcc(uint32_t address)
+{
+  if (!(getConfiguration() & ECS_MASK))
+  {
+    return;
+  }
+
+  uint16_t page = address / MAX_MEMORY_PAGE_SIZE;
+  for (uint8_t i = 0; i < m_ecc_event_count; ++i)
+  {
+    if (m_ecc_events[i].page == page)
+    {
+      if (m_ecc_events[i].count < 0xFF)
+      {
+        m_ecc_events[i].count++;
+      }
+      return;
+    }
+  }
+  if (m_ecc_event_count < MEM24CSM01_ECC_TABLE_SIZE)
+  {
+    m_ecc_events[m_ecc_event_count].page = page;
+    m_ecc_events[m_ecc_event_count].count = 1;
+    m_ecc_event_count++;
+  }
+  else if (m_ecc_events_lost < 0xFFFF)
+  {
+    m_ecc_events_lost++;
+  }
+}
+
+/**
+ * @brief Starts an asynchronous write of a block of any size.
+ *
+ * The block is written page by page like writeBulk(), but every step is executed by
+ * service(), that must be called periodically (e.g. from loop()). Each call performs at
+ * most one bus transaction, a page transmission or a single ACK poll, so the time spent
+ * in service() is bounded by the transmission of one page.
+ * The data buffer is not copied and must stay valid until the write is completed.
+ *
+ * @param address The starting address in the EEPROM memory where the data will be written.
+ * @param dataArray A pointer to the array of data to be written to the EEPROM memory.
+ * @param arraySize The size of the data array, up to the full memory size.
+ * @param callback Optional function called with the final result when the write completes.
+ * @return MEMORYRESULT::OK if the write has been queued.
+ *         MEMORYRESULT::BUSY if another asynchronous write is still running.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the maximum allowed memory address.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the data block does not fit in the remaining memory.
+ *         MEMORYRESULT::WRITE_PROTECTED if the whole block is in write protected zones.
+ *         The protected zones of a block partially writable are skipped, the final result is WRITE_PROTECTED.
+ */
+MEMORYRESULT Mem24CSM01::beginWrite(uint32_t address, const uint8_t *dataArray, size_t arraySize, WriteCompleteCallback callback)
+{
+  MEM24CSM01_LOCK();
+  if (m_async_state != ASYNCWRITESTATE::ASYNC_IDLE)
+  {
+    return (MEMORYRESULT::BUSY);
+  }
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (arraySize > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  if (arraySize > 0 && protectedSize(address, arraySize) == arraySize) // Nothing can be written
+  {
+    return (MEMORYRESULT::WRITE_PROTECTED);
+  }
+
+  m_async_protected = false;
+  m_async_attempt = 0;
+  m_async_address = address;
+  m_async_data = dataArray;
+  m_async_remaining = arraySize;
+  m_async_callback = callback;
+  m_async_result = MEMORYRESULT::BUSY;
+  m_async_poll_start = m_bus->getMillis();
+  m_async_state = ASYNCWRITESTATE::ASYNC_WAIT_WRITE_CYCLE; // A previous write cycle may still be running
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Advances the asynchronous write engine by one step.
+ *
+ * A step is either the transmission of the next page or a single ACK poll of the
+ * running write cycle. When the last write cycle is over, or an error occurs, the
+ * engine goes back to idle and the completion callback is called.
+ *
+ * @return MEMORYRESULT::BUSY while the write is running, otherwise the result of the last asynchronous write.
+ */
+MEMORYRESULT Mem24CSM01::service()
+{
+  MEM24CSM01_LOCK();
+  switch (m_async_state)
+  {
+  case ASYNCWRITESTATE::ASYNC_WAIT_WRITE_CYCLE:
+  {
+    bool polled = m_write_in_progress; // isWriteInProgress() uses the bus only if a write cycle was started
+    if (isWriteInProgress())
+    {
+      if (m_bus->getMillis() - m_async_poll_start >= m_write_timeout)
+      {
+        finishAsyncWrite(MEMORYRESULT::TIMEOUT);
+      }
+      break;
+    }
+    if (m_async_remaining == 0)
+    {
+      finishAsyncWrite(m_async_protected ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
+      break;
+    }
+    m_async_state = ASYNCWRITESTATE::ASYNC_WRITE_PAGE;
+    if (polled)
+    {
+      break; // Only one bus transaction per call
+    }
+  }
+  // fall through
+  case ASYNCWRITESTATE::ASYNC_WRITE_PAGE:
+  {
+    size_t protectedBytes = protectedSize(m_async_address, m_async_remaining);
+    if (protectedBytes > 0) // Skip the protected zones, beginWrite() ensured part of the block is writable
+    {
+      m_async_address += protectedBytes;
+      m_async_data += protectedBytes;
+      m_async_remaining -= protectedBytes;
+      m_async_protected = true;
+      if (m_async_remaining == 0)
+      {
+        finishAsyncWrite(MEMORYRESULT::WRITE_PROTECTED);
+        break;
+      }
+    }
+    m_async_chunk_size = writeChunkSize(m_async_address, m_async_remaining);
+    WriteSegment segment = {m_async_data, m_async_chunk_size};
+#ifdef MEM24CSM01_ENABLE_STATS
+    m_async_transfer_start = m_bus->getMicros();
+#endif
+    if (queueWrite(m_async_address, &segment, 0, m_async_chunk_size) != m_async_chunk_size + 2)
+    {
+      endTransmission(); // Release the bus, only the first bytes would be written
+      finishAsyncWrite(MEMORYRESULT::WIRE_BUFFER_OVERFLOW);
+      break;
+    }
+    m_bus_held = false;
+    m_address_pointer = ADDRESS_POINTER_UNKNOWN;
+    m_bus->endTransmissionAsync(); // The backend may transfer the page in background
+    m_async_state = ASYNCWRITESTATE::ASYNC_TRANSFER;
+  }
+  // fall through
+  case ASYNCWRITESTATE::ASYNC_TRANSFER:
+  {
+    if (m_bus->isTransmissionPending())
+    {
+      break;
+    }
+    MEMORYRESULT result = processTransmissionResult(m_bus->getTransmissionResult());
+#ifdef MEM24CSM01_ENABLE_STATS
+    recordTransaction(BUSOPERATION::BUS_WRITE, m_async_address, m_async_chunk_size, result, m_async_transfer_start);
+#endif
+    if (result != MEMORYRESULT::OK)
+    {
+      if (retryAfter(result, &m_async_attempt))
+      {
+        m_async_state = ASYNCWRITESTATE::ASYNC_WRITE_PAGE;
+      }
+      else
+      {
+        finishAsyncWrite(result);
+      }
+      break;
+    }
+    retryAfter(result, &m_async_attempt);
+    m_async_attempt = 0;
+    m_write_in_progress = true; // The chip starts the internal write cycle after the stop condition
+    m_write_cycle_start = m_bus->getMicros();
+    followWrite(m_async_address, m_async_chunk_size);
+    STATS_COUNT(pageWrites, 1);
+    STATS_COUNT(bytesWritten, m_async_chunk_size);
+    m_async_address += m_async_chunk_size;
+    m_async_data += m_async_chunk_size;
+    m_async_remaining -= m_async_chunk_size;
+    m_async_poll_start = m_bus->getMillis();
+    m_async_state = ASYNCWRITESTATE::ASYNC_WAIT_WRITE_CYCLE;
+    break;
+  }
+  default:
+    break;
+  }
+  return (m_async_result);
+}
+
+/**
+ * @brief Returns the status of the asynchronous write.
+ *
+ * @return MEMORYRESULT::BUSY while the write is running, otherwise the result of the last asynchronous write.
+ */
+MEMORYRESULT Mem24CSM01::getWriteStatus()
+{
+  return (m_async_result);
+}
+
+/**
+ * @brief Stops the asynchronous write engine and reports the result.
+ *
+ * @param result The final result of the asynchronous write.
+ */
+void Mem24CSM01::finishAsyncWrite(MEMORYRESULT result)
+{
+  m_async_state = ASYNCWRITESTATE::ASYNC_IDLE;
+  m_async_result = result;
+  if (m_async_callback != nullptr)
+  {
+    m_async_callback(result);
+  }
+}
+
+/**
+ * @brief Starts a transmission to the chip.
+ *
+ * In high-speed mode the master code is sent first, the chip leaves high-speed mode
+ * at every stop condition.
+ *
+ * @param deviceAddress The 7-bit device address.
+ */
+void Mem24CSM01::beginTransmission(uint8_t deviceAddress)
+{
+  if (m_high_speed && !m_bus_held)
+  {
+    enterHighSpeedMode();
+  }
+  m_bus->countTransaction();
+  if (deviceAddress == m_dev_address_configuration_reg)
+  {
+    m_address_pointer = ADDRESS_POINTER_UNKNOWN; // The register accesses move the address pointer
+  }
+  m_bus->beginTransmission(deviceAddress);
+}
+
+/**
+ * @brief Ends a transmission to the chip.
+ *
+ * @param sendStop true to release the bus with a stop condition, false to keep it with a repeated start.
+ * @return uint8_t The Wire library transmission result.
+ */
+uint8_t Mem24CSM01::endTransmission(bool sendStop)
+{
+  m_bus_held = !sendStop;
+  return (m_bus->endTransmission(sendStop));
+}
+
+/**
+ * @brief Requests bytes from the chip and releases the bus with a stop condition.
+ *
+ * @param deviceAddress The 7-bit device address.
+ * @param quantity The number of bytes to read.
+ * @return uint8_t The number of bytes received in the Wire buffer.
+ */
+uint8_t Mem24CSM01::requestFrom(uint8_t deviceAddress, uint8_t quantity)
+{
+  if (m_high_speed && !m_bus_held)
+  {
+    enterHighSpeedMode();
+  }
+  m_bus_held = false;
+  m_bus->countTransaction();
+  return (m_bus->requestFrom(deviceAddress, quantity));
+}
+
+/**
+ * @brief Switches the bus to high-speed mode for the next transaction.
+ *
+ * The master code is sent at 400 kHz, no device acknowledges it, then the transaction
+ * continues with a repeated start at the high-speed clock.
+ */
+void Mem24CSM01::enterHighSpeedMode()
+{
+  m_bus->setClock(MEM24CSM01_CLOCK_FAST);
+  m_bus->beginTransmission(HS_MASTER_CODE);
+  m_bus->endTransmission(false); // The master code is never acknowledged, keep the bus with a repeated start
+  m_bus->setClock(m_clock);
+}
+
+#ifdef MEM24CSM01_ENABLE_STATS
+/**
+ * @brief Returns the bus statistics collected since the last reset.
+ *
+ * Available only when the library is built with MEM24CSM01_ENABLE_STATS.
+ *
+ * @return const MemoryStatistics& The statistics.
+ */
+const MemoryStatistics &Mem24CSM01::getStatistics()
+{
+  return (m_stats);
+}
+
+/**
+ * @brief Clears the bus statistics.
+ */
+void Mem24CSM01::resetStatistics()
+{
+  memset(&m_stats, 0, sizeof(m_stats));
+  for (uint8_t i = 0; i < BUSOPERATION_COUNT; ++i)
+  {
+    m_stats.timing[i].minMicros = UINT32_MAX;
+  }
+}
+
+/**
+ * @brief Sets a function called after every bus transaction.
+ *
+ * The callback runs in the middle of the library operations, it must be short and must not use the chip.
+ *
+ * @param callback The trace callback, nullptr to disable it.
+ */
+void Mem24CSM01::setTraceCallback(TraceCallback callback)
+{
+  m_trace_callback = callback;
+}
+
+/**
+ * @brief Updates the timing statistics and calls the trace callback.
+ *
+ * @param operation The class of the transaction.
+ * @param address The memory address of the transaction.
+ * @param size The number of data bytes transferred.
+ * @param result The result of the transaction.
+ * @param start The time in microseconds at the start of the transaction, see Mem24CSM01Backend::getMicros().
+ */
+void Mem24CSM01::recordTransaction(BUSOPERATION operation, uint32_t address, size_t size, MEMORYRESULT result, unsigned long start)
+{
+  uint32_t duration = m_bus->getMicros() - start;
+  OperationTiming &timing = m_stats.timing[operation];
+  timing.count++;
+  timing.totalMicros += duration;
+  if (duration < timing.minMicros)
+  {
+    timing.minMicros = duration;
+  }
+  if (duration > timing.maxMicros)
+  {
+    timing.maxMicros = duration;
+  }
+  if (m_trace_callback != nullptr)
+  {
+    BusTrace trace = {operation, address, size, result, duration};
+    m_trace_callback(trace);
+  }
+}
+#endif
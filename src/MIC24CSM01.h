@@ -11,6 +11,17 @@
 #include <stdint.h>
 #include <Arduino.h>
 #include <Wire.h>
+#include "MIC24CSM01Backend.h"
+#include "MIC24CSM01Crc.h"
+#ifdef MEM24CSM01_ENABLE_RTOS
+#if defined(__has_include) && __has_include(<freertos/FreeRTOS.h>)
+#include <freertos/FreeRTOS.h> // ESP32 layout
+#include <freertos/semphr.h>
+#else
+#include <FreeRTOS.h>
+#include <semphr.h>
+#endif
+#endif
 
 // Wire library accept only 7-bit addresses!
 #define BASE_MEMREG_ADDR 0b1010000 // This is the default device address type for the memory register
@@ -25,10 +36,13 @@
 
 #define FIRST_RESERVED_HOST_CODE 0b1111100  // Reserved host code for accessing the manufacturer register
 #define SECOND_RESERVED_HOST_CODE 0b1111100 // Reserved host code for accessing the manufacturer register
+#define MANUFACTURER_REGISTER_BYTE_SIZE 3   // The size of the manufacturer register
+#define MANUFACTURER_CODE_MICROCHIP 0x00D   // Manufacturer code of the 24CSM01 (register 00D0D0h)
 
 #define ECS_MASK 0b1 << 15 // Error Correction State mask
 #define EWPM_MASK 0b1 << 9 // Enhanced Software Write Protection Mode mask
 #define LOCK_MASK 0b1 << 8 // Configuration Register Lock mask
+#define CONFIG_VALUE_MASK 0x03FF // Writable bits of the configuration register: EWPM, LOCK and SWP
 
 // #define CFGREG_EWPM 9
 // #define CFGREG_LOCK 8
@@ -36,8 +50,67 @@
 #define REGISTER_LOCKED 0x99 // Attention! This is the value write to the configuration register lock it permanently
 #define REGISTER_UNLOCKED 0x66
 
+#define HS_MASTER_CODE 0b0000100 // High-speed mode master code 00001XXX, sent as a 7-bit address with the write bit
+
+// I2C bus clock frequencies supported by the chip
+#define MEM24CSM01_CLOCK_STANDARD 100000    // Standard-mode, 100 kHz
+#define MEM24CSM01_CLOCK_FAST 400000        // Fast-mode, 400 kHz
+#define MEM24CSM01_CLOCK_FAST_PLUS 1000000  // Fast-mode Plus, 1 MHz
+#define MEM24CSM01_CLOCK_HIGH_SPEED 3400000 // High-speed mode, 3.4 MHz (needs MEM24CSM01_ENABLE_HS_MODE)
+
 #define MAX_MEMORY_ADDRESS_VALUE 0x1FFFF // Maximum memory address value
 #define MAX_MEMORY_PAGE_SIZE 256         // A page write operation allows up to 256 bytes to be written in the same write cycle
+#define MEMORY_SIZE 0x20000              // Total size of the memory array in bytes (128 KiB)
+#define ZONE_SIZE 0x4000                 // Size of a software write protection zone (16 KiB)
+#define ERASED_VALUE 0xFF                // Value written by erase()
+#define WRITE_CYCLE_TIME 5               // Maximum internal write cycle time (tWC) in milliseconds
+#define WRITE_CYCLE_TIMEOUT 10           // Default time in milliseconds to wait for the end of the write cycle before giving up
+
+#define ADDRESS_POINTER_UNKNOWN 0xFFFFFFFF // Shadow value when the chip address pointer is not known
+
+// Size of the Wire library transmit and receive buffers, it can be overridden with a build flag
+#ifndef MEM24CSM01_WIRE_BUFFER_SIZE
+#if defined(I2C_BUFFER_LENGTH) // ESP32
+#define MEM24CSM01_WIRE_BUFFER_SIZE I2C_BUFFER_LENGTH
+#elif defined(WIRE_BUFFER_SIZE) // RP2040
+#define MEM24CSM01_WIRE_BUFFER_SIZE WIRE_BUFFER_SIZE
+#elif defined(ARDUINO_ARCH_SAMD) // SAMD, the Wire buffers are 256 bytes ring buffers
+#define MEM24CSM01_WIRE_BUFFER_SIZE 256
+#elif defined(BUFFER_LENGTH) // AVR
+#define MEM24CSM01_WIRE_BUFFER_SIZE BUFFER_LENGTH
+#else
+#define MEM24CSM01_WIRE_BUFFER_SIZE 32
+#endif
+#endif
+
+// Maximum number of bytes requested with a single Wire.requestFrom(), the quantity is an uint8_t on AVR
+#if MEM24CSM01_WIRE_BUFFER_SIZE > 255
+#define MEM24CSM01_READ_CHUNK_SIZE 255
+#else
+#define MEM24CSM01_READ_CHUNK_SIZE MEM24CSM01_WIRE_BUFFER_SIZE
+#endif
+
+// Maximum number of data bytes sent with a single transmission, the two address bytes share the Wire buffer
+#if MEM24CSM01_WIRE_BUFFER_SIZE - 2 > MAX_MEMORY_PAGE_SIZE
+#define MEM24CSM01_WRITE_CHUNK_SIZE MAX_MEMORY_PAGE_SIZE
+#else
+#define MEM24CSM01_WRITE_CHUNK_SIZE (MEM24CSM01_WIRE_BUFFER_SIZE - 2)
+#endif
+
+// Number of pages recorded by the ECC sampling, see setEccSampling()
+#ifndef MEM24CSM01_ECC_TABLE_SIZE
+#define MEM24CSM01_ECC_TABLE_SIZE 8
+#endif
+
+// Size of the stack buffer used to compare the memory content with new data
+#ifndef MEM24CSM01_COMPARE_CHUNK_SIZE
+#define MEM24CSM01_COMPARE_CHUNK_SIZE 32
+#endif
+
+// Size of the stack buffer holding the repeated pattern of fill(), also the longest pattern
+#ifndef MEM24CSM01_FILL_BLOCK_SIZE
+#define MEM24CSM01_FILL_BLOCK_SIZE 32
+#endif
 
 /**
  * @enum MEMORYRESULT
@@ -68,6 +141,27 @@
  *
  * @var MEMORYRESULT::GENERIC_ERROR
  * A generic error occurred during the operation.
+ *
+ * @var MEMORYRESULT::BUSY
+ * An asynchronous operation is still running.
+ *
+ * @var MEMORYRESULT::WIRE_BUFFER_OVERFLOW
+ * The Wire transmit buffer could not hold all the bytes of the transmission.
+ *
+ * @var MEMORYRESULT::NOT_FOUND
+ * The requested record or key does not exist.
+ *
+ * @var MEMORYRESULT::CRC_ERROR
+ * The CRC stored with the data does not match the data read.
+ *
+ * @var MEMORYRESULT::WRITE_PROTECTED
+ * The address is in a write protected zone, the data has not been sent.
+ *
+ * @var MEMORYRESULT::MISMATCH
+ * The memory content or a register is different from the expected value.
+ *
+ * @var MEMORYRESULT::INVALID_PARAMETER
+ * A size or count given to a constructor is out of range, detected by begin().
  */
 typedef enum
 {
@@ -79,8 +173,159 @@ typedef enum
   DATA_ERROR,
   TIMEOUT,
   GENERIC_ERROR,
+  BUSY,
+  WIRE_BUFFER_OVERFLOW,
+  NOT_FOUND,
+  CRC_ERROR,
+  WRITE_PROTECTED,
+  MISMATCH,
+  INVALID_PARAMETER,
 } MEMORYRESULT;
 
+#define MEMORYRESULT_COUNT 15 // Number of MEMORYRESULT values
+
+/**
+ * @enum BUSOPERATION
+ * @brief Class of a bus transaction, used by the statistics and the trace callback.
+ *
+ * @var BUSOPERATION::BUS_READ
+ * Read of the memory array.
+ *
+ * @var BUSOPERATION::BUS_WRITE
+ * Write transaction to the memory array, each one starts a write cycle.
+ *
+ * @var BUSOPERATION::BUS_CONFIGURATION
+ * Access to the configuration, security or manufacturer register.
+ *
+ * @var BUSOPERATION::BUS_ACK_POLL
+ * ACK poll of a running write cycle.
+ */
+typedef enum
+{
+  BUS_READ,
+  BUS_WRITE,
+  BUS_CONFIGURATION,
+  BUS_ACK_POLL,
+} BUSOPERATION;
+
+#define BUSOPERATION_COUNT 4 // Number of BUSOPERATION values
+
+/**
+ * @struct OperationTiming
+ * @brief Duration statistics of a class of bus transactions, measured with Mem24CSM01Backend::getMicros().
+ */
+typedef struct
+{
+  uint32_t count;       // Number of transactions
+  uint32_t totalMicros; // Sum of the durations, divide by count for the average
+  uint32_t minMicros;   // Shortest duration
+  uint32_t maxMicros;   // Longest duration
+} OperationTiming;
+
+/**
+ * @struct MemoryStatistics
+ * @brief Counters collected when the library is built with MEM24CSM01_ENABLE_STATS.
+ */
+typedef struct
+{
+  uint32_t reads;                                   // Read operations (API calls)
+  uint32_t writes;                                  // Write operations (API calls)
+  uint32_t bytesRead;                               // Bytes read from the memory array
+  uint32_t bytesWritten;                            // Bytes written to the memory array
+  uint32_t pageWrites;                              // Write transactions, each one costs a write cycle
+  uint32_t ackPolls;                                // ACK polling iterations
+  uint32_t retries;                                 // Transactions repeated by the retry policy
+  uint32_t busRecoveries;                           // Bus recoveries started by the retry policy
+  uint32_t transmissionResults[MEMORYRESULT_COUNT]; // Results of the transmissions, indexed by MEMORYRESULT
+  OperationTiming timing[BUSOPERATION_COUNT];       // Transaction durations, indexed by BUSOPERATION
+} MemoryStatistics;
+
+/**
+ * @struct BusTrace
+ * @brief Description of a bus transaction passed to the trace callback.
+ */
+typedef struct
+{
+  BUSOPERATION operation; // Class of the transaction
+  uint32_t address;       // Memory address, 0 for register accesses
+  size_t size;            // Number of data bytes transferred
+  MEMORYRESULT result;    // Result of the transaction
+  uint32_t duration;      // Duration in microseconds
+} BusTrace;
+
+typedef void (*TraceCallback)(const BusTrace &trace); // Called after every bus transaction
+
+/**
+ * @enum ASYNCWRITESTATE
+ * @brief State of the asynchronous write engine.
+ *
+ * @var ASYNCWRITESTATE::ASYNC_IDLE
+ * No asynchronous write is running.
+ *
+ * @var ASYNCWRITESTATE::ASYNC_WRITE_PAGE
+ * The next page has to be transmitted.
+ *
+ * @var ASYNCWRITESTATE::ASYNC_WAIT_WRITE_CYCLE
+ * Waiting for the end of the write cycle with ACK polling.
+ *
+ * @var ASYNCWRITESTATE::ASYNC_TRANSFER
+ * The page is being transferred by the bus backend.
+ */
+typedef enum
+{
+  ASYNC_IDLE,
+  ASYNC_WRITE_PAGE,
+  ASYNC_WAIT_WRITE_CYCLE,
+  ASYNC_TRANSFER,
+} ASYNCWRITESTATE;
+
+/**
+ * @struct WriteSegment
+ * @brief Block of data written by writev().
+ */
+typedef struct
+{
+  const uint8_t *data; // Pointer to the data
+  size_t size;         // Number of bytes
+} WriteSegment;
+
+/**
+ * @struct ReadSegment
+ * @brief Buffer filled by readv().
+ */
+typedef struct
+{
+  uint8_t *data; // Pointer to the buffer
+  size_t size;   // Number of bytes
+} ReadSegment;
+
+/**
+ * @struct EccEvent
+ * @brief Page where a sampled read needed the error correction.
+ */
+typedef struct
+{
+  uint16_t page; // Page number, the page address is page * MAX_MEMORY_PAGE_SIZE
+  uint8_t count; // Number of sampled reads of the page that needed the correction, saturates at 255
+} EccEvent;
+
+/**
+ * @struct RetryPolicy
+ * @brief Retries of the failed bus transactions, see setRetryPolicy().
+ */
+typedef struct
+{
+  uint8_t maxAttempts;          // Attempts of every transaction, 1 disables the retries
+  uint16_t backoffMicros;       // Delay before the first retry, doubled at every further retry
+  uint16_t retryMask;           // Results retried, built with RETRY_ON()
+  uint8_t busRecoveryThreshold; // Consecutive TIMEOUT or GENERIC_ERROR results starting a bus recovery, 0 disables it
+} RetryPolicy;
+
+#define RETRY_ON(result) (1U << (result)) // Bit of a MEMORYRESULT in RetryPolicy::retryMask
+#define DEFAULT_RETRY_MASK (RETRY_ON(MEMORYRESULT::ADDRESS_ERROR) | RETRY_ON(MEMORYRESULT::DATA_ERROR) | RETRY_ON(MEMORYRESULT::TIMEOUT) | RETRY_ON(MEMORYRESULT::GENERIC_ERROR))
+
+typedef void (*WriteCompleteCallback)(MEMORYRESULT result); // Called when an asynchronous write completes
+
 // Configuration register structure
 /*
 bit 15: Error Correction State (ECS)
@@ -145,6 +390,48 @@ typedef struct
   uint8_t deviceRevision; // Device revision
 } ManufacturerRegister;
 
+/**
+ * @struct DeviceIdentity
+ * @brief Immutable identification of the chip, read once and served from memory.
+ *
+ * @var DeviceIdentity::serialNumber
+ * The 128-bit serial number of the security register.
+ *
+ * @var DeviceIdentity::manufacturerRegister
+ * The 24-bit manufacturer register as read, 00D0D0h for the 24CSM01.
+ *
+ * @var DeviceIdentity::manufacturer
+ * The decoded fields of the manufacturer register.
+ */
+typedef struct
+{
+  uint8_t serialNumber[SERIAL_NUMBER_BYTE_SIZE]; // Serial number
+  uint32_t manufacturerRegister;                 // Raw manufacturer register
+  ManufacturerRegister manufacturer;             // Decoded manufacturer register
+} DeviceIdentity;
+
+/**
+ * @struct Mem24CSM01Schema
+ * @brief Layout version of a type stored with put() and read with get().
+ *
+ * The version is 0 by default and the object is stored alone. Declare a version with
+ * MEM24CSM01_SCHEMA(type, version): a byte holding it is then stored before the object
+ * and get() returns MEMORYRESULT::MISMATCH when the stored version is a different one,
+ * e.g. after a firmware update changed the layout of the structure.
+ */
+template <typename T>
+struct Mem24CSM01Schema
+{
+  static constexpr uint8_t version = 0;
+};
+
+#define MEM24CSM01_SCHEMA(type, schemaVersion)        \
+  template <>                                         \
+  struct Mem24CSM01Schema<type>                       \
+  {                                                   \
+    static constexpr uint8_t version = schemaVersion; \
+  };
+
 /**
  * @struct WriteAddressPacket
  * @brief Structure to represent the address packet for writing to the EEPROM.
@@ -170,38 +457,243 @@ typedef struct
 
 uint8_t zoneProtection(bool zone7 = 0, bool zone6 = 0, bool zone5 = 0, bool zone4 = 0, bool zone3 = 0, bool zone2 = 0, bool zone1 = 0, bool zone0 = 0);
 
+// Maps an endTransmission() code to a MEMORYRESULT, shared by Mem24CSM01 and Mem24CSM01T
+inline MEMORYRESULT transmissionToMemoryResult(int transmissionResult)
+{
+  switch (transmissionResult)
+  {
+  case 0:
+    return (MEMORYRESULT::OK);
+  case 2:
+    return (MEMORYRESULT::ADDRESS_ERROR);
+  case 3:
+    return (MEMORYRESULT::DATA_ERROR);
+  case 5:
+    return (MEMORYRESULT::TIMEOUT);
+  default:
+    return (MEMORYRESULT::GENERIC_ERROR);
+  }
+}
+
 class Mem24CSM01
 {
 public:
-  Mem24CSM01(uint8_t memoryRegister);
-  Mem24CSM01(bool A1, bool A2);
-  void begin();
+  Mem24CSM01(uint8_t memoryRegister, TwoWire &wire = Wire);
+  Mem24CSM01(bool A1, bool A2, TwoWire &wire = Wire);
+  Mem24CSM01(bool A1, bool A2, Mem24CSM01Backend &backend);
+  void begin(uint32_t clock = 0);
 
   uint16_t getConfiguration();
   bool getSerialNumber(uint8_t *data, uint8_t arraySize);
   uint64_t getManufacturerRegister();
+  const DeviceIdentity *getIdentity();
+  MEMORYRESULT refreshIdentity();
   bool updateConfigRegister(uint8_t confirmLock = 0x66);
   bool enableSoftwareWriteProtect();
   bool disableSoftwareWriteProtect();
   bool setWriteProtectionZone(uint8_t zone);
   bool writeProtection(uint8_t zones);
   bool removeWriteProtectionZone(uint8_t zone);
+  size_t protectedSize(uint32_t address, size_t size);
+  bool beginConfigUpdate();
+  bool commitConfig();
+  void cancelConfigUpdate();
 
   MEMORYRESULT read(uint8_t *data);
   MEMORYRESULT read(uint32_t address, uint8_t *data);
-  MEMORYRESULT read(uint32_t address, uint8_t *buffer, size_t size);
+  MEMORYRESULT read(uint32_t address, uint8_t *buffer, size_t size, size_t *bytesRead = nullptr);
+  MEMORYRESULT readv(uint32_t address, const ReadSegment *segments, uint8_t count, size_t *bytesRead = nullptr);
   MEMORYRESULT write(uint32_t address, uint8_t singleByte);
   MEMORYRESULT write(uint32_t address, uint8_t *dataArray, size_t arraySize);
+  MEMORYRESULT writeBulk(uint32_t address, const uint8_t *dataArray, size_t arraySize);
+  MEMORYRESULT writev(uint32_t address, const WriteSegment *segments, uint8_t count);
+  MEMORYRESULT update(uint32_t address, const uint8_t *dataArray, size_t arraySize);
+  MEMORYRESULT updateFrom(uint32_t address, const uint8_t *dataArray, const uint8_t *previous, size_t arraySize);
+  MEMORYRESULT fill(uint32_t address, uint8_t value, size_t size);
+  MEMORYRESULT fill(uint32_t address, const uint8_t *pattern, uint8_t patternSize, size_t size);
+  MEMORYRESULT erase(uint8_t zone);
+  MEMORYRESULT erase();
+  MEMORYRESULT compare(uint32_t address, const uint8_t *data, size_t size, uint32_t *mismatchAddress = nullptr);
+  MEMORYRESULT verifyFill(uint32_t address, uint8_t value, size_t size, uint32_t *mismatchAddress = nullptr);
+  MEMORYRESULT writeChecked(uint32_t address, const uint8_t *dataArray, size_t arraySize, CRCTYPE type = CRCTYPE::CRC_16);
+  MEMORYRESULT readChecked(uint32_t address, uint8_t *buffer, size_t size, CRCTYPE type = CRCTYPE::CRC_16);
+  template <typename T>
+  MEMORYRESULT put(uint32_t address, const T &value);
+  template <typename T>
+  MEMORYRESULT put(uint32_t address, const T &value, const T &previous);
+  template <typename T>
+  MEMORYRESULT get(uint32_t address, T &value);
+  template <typename T>
+  static constexpr size_t storedSize();
+  template <typename T>
+  static constexpr size_t maxPagesSpanned();
+  MEMORYRESULT requestSequential(uint32_t address, size_t size, size_t *received);
+  int readBuffered();
+  int peekBuffered();
+  uint32_t getTransactionCount();
+  Mem24CSM01Backend *getBackend();
+  MEMORYRESULT waitForWriteCompletion();
+  bool isWriteInProgress();
+  bool isWriteCycleActive();
+  uint32_t getWriteCycleRemaining();
+  void setWriteTimeout(uint16_t timeout);
+  void setRetryPolicy(const RetryPolicy &policy);
+  void setBusPins(uint8_t sdaPin, uint8_t sclPin);
+  bool recoverBus();
+
+  MEMORYRESULT beginWrite(uint32_t address, const uint8_t *dataArray, size_t arraySize, WriteCompleteCallback callback = nullptr);
+  MEMORYRESULT service();
+  MEMORYRESULT getWriteStatus();
+
+  void setEccSampling(uint16_t everyReads, uint8_t suspectZones = 0);
+  const EccEvent *getEccEvents(uint8_t *count);
+  uint16_t getEccEventsLost();
+  void clearEccEvents();
+
+#ifdef MEM24CSM01_ENABLE_STATS
+  const MemoryStatistics &getStatistics();
+  void resetStatistics();
+  void setTraceCallback(TraceCallback callback);
+#endif
 
 private:
+  void init(uint8_t memoryAddress, uint8_t configAddress);
   WriteAddressPacket configureAddressPacket(uint32_t address);
+  bool readConfigRegister(uint16_t *value);
+  MEMORYRESULT readSerialNumber(uint8_t *data);
+  MEMORYRESULT readManufacturerRegister(uint32_t *value);
+  bool loadConfiguration();
+  bool applyConfigChange();
+  uint16_t configValue();
+  MEMORYRESULT comparePattern(uint32_t address, const uint8_t *pattern, size_t patternSize, size_t size, uint32_t *mismatchAddress);
   MEMORYRESULT processTransmissionResult(int transmissionResult);
+  size_t queueWrite(uint32_t address, const WriteSegment *segments, size_t offset, size_t arraySize);
+  MEMORYRESULT writeTransaction(uint32_t address, const WriteSegment *segments, size_t offset, size_t arraySize);
+  size_t writeChunkSize(uint32_t address, size_t remaining);
+  void finishAsyncWrite(MEMORYRESULT result);
+  bool isEccSuspect(uint32_t address, size_t size);
+  void sampleEcc(uint32_t address);
+  bool retryAfter(MEMORYRESULT result, uint8_t *attempt);
   uint8_t addressMemoryPointer(uint32_t address);
+  bool isPointerAt(uint32_t address);
+  void followWrite(uint32_t address, size_t size);
+  void beginTransmission(uint8_t deviceAddress);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t deviceAddress, uint8_t quantity);
+  void enterHighSpeedMode();
+  Mem24CSM01WireBackend m_wire_backend;    // Default backend on the Wire library
+  Mem24CSM01Backend *m_bus;                // Backend used for every bus transaction
+  uint32_t m_clock;                        // I2C bus clock frequency, 0 when left to the Wire library default
+  bool m_high_speed;                       // True when every transaction starts with the high-speed master code
+  bool m_bus_held;                         // True after a transmission ended with a repeated start
+  uint32_t m_address_pointer;              // Shadow of the chip address pointer, ADDRESS_POINTER_UNKNOWN when not known
+#ifdef MEM24CSM01_ENABLE_RTOS
+  SemaphoreHandle_t m_mutex;               // Recursive bus lock held for each complete operation
+  uint8_t m_lock_depth;                    // Levels of m_mutex taken by the task holding it
+#endif
+#ifdef MEM24CSM01_ENABLE_STATS
+  void recordTransaction(BUSOPERATION operation, uint32_t address, size_t size, MEMORYRESULT result, unsigned long start);
+  MemoryStatistics m_stats;                // Bus statistics
+  TraceCallback m_trace_callback;          // Trace callback, can be nullptr
+#endif
   uint8_t m_dev_address_memory_access;     // Device address byte for Memory access
   uint8_t m_dev_address_configuration_reg; // Device address byte for Configuration register access
   uint8_t m_dev_address_security_register; // Device address byte for Security register access
   ConfigurationRegister m_configuration;   // Configuration register
-  ManufacturerRegister m_manufacturer;     // Manufacturer identification register
+  DeviceIdentity m_identity;               // Serial number and manufacturer register
+  bool m_identity_loaded;                  // True when m_identity holds the registers content
+  bool m_config_loaded;                    // True when m_configuration holds the register content
+  bool m_config_transaction;               // True between beginConfigUpdate() and commitConfig()
+  bool m_config_locked_on_chip;            // True when the register is permanently locked
+  uint16_t m_config_value;                 // Writable bits of the register as last read or written
+  uint16_t m_write_timeout;                // Maximum time in milliseconds to wait for the end of a write cycle
+  RetryPolicy m_retry_policy;              // Retries of the failed transactions
+  uint8_t m_failure_count;                 // Consecutive TIMEOUT or GENERIC_ERROR results
+  uint8_t m_sda_pin;                       // SDA pin used by the bus recovery
+  uint8_t m_scl_pin;                       // SCL pin used by the bus recovery
+  bool m_write_in_progress;                // True after a write until the chip acknowledges again
+  unsigned long m_write_cycle_start;       // Bus time in microseconds at the start of the last write cycle
+  ASYNCWRITESTATE m_async_state;           // State of the asynchronous write engine
+  MEMORYRESULT m_async_result;             // Result of the last asynchronous write, BUSY while running
+  uint32_t m_async_address;                // Next address to write
+  const uint8_t *m_async_data;             // Next byte to write, owned by the caller until completion
+  size_t m_async_remaining;                // Bytes left to write
+  unsigned long m_async_poll_start;        // Bus time in milliseconds at the start of the current write cycle wait
+  WriteCompleteCallback m_async_callback;  // Completion callback, can be nullptr
+  bool m_async_protected;                  // True when protected zones of the block have been skipped
+  size_t m_async_chunk_size;               // Size of the page being transferred
+  uint8_t m_async_attempt;                 // Failed attempts of the page being transferred
+#ifdef MEM24CSM01_ENABLE_STATS
+  unsigned long m_async_transfer_start;    // Bus time in microseconds at the start of the page transfer
+#endif
+  uint16_t m_ecc_interval;                 // Reads between two ECS checks, 0 when disabled
+  uint8_t m_ecc_suspect_zones;             // Zones whose reads are always followed by an ECS check
+  uint16_t m_ecc_read_count;               // Reads since the last periodic ECS check
+  EccEvent m_ecc_events[MEM24CSM01_ECC_TABLE_SIZE]; // Pages where the correction has been needed
+  uint8_t m_ecc_event_count;               // Entries used in m_ecc_events
+  uint16_t m_ecc_events_lost;              // Corrections not recorded because the table was full
 };
 
+// Bytes taken in memory by an object, version byte included
+template <typename T>
+constexpr size_t Mem24CSM01::storedSize()
+{
+  return (sizeof(T) + (Mem24CSM01Schema<T>::version != 0 ? 1 : 0));
+}
+
+// Most pages an object can span, the number of write cycles of a full save when the Wire buffer holds a page
+template <typename T>
+constexpr size_t Mem24CSM01::maxPagesSpanned()
+{
+  return ((storedSize<T>() + MAX_MEMORY_PAGE_SIZE - 2) / MAX_MEMORY_PAGE_SIZE + 1);
+}
+
+// Stores an object, only the pages holding changed bytes are written (see update())
+template <typename T>
+MEMORYRESULT Mem24CSM01::put(uint32_t address, const T &value)
+{
+  static_assert(__is_trivially_copyable(T), "put() stores the bytes of the object, the type must be trivially copyable");
+  static_assert(storedSize<T>() <= MEMORY_SIZE, "The type does not fit in the memory");
+  if (Mem24CSM01Schema<T>::version != 0)
+  {
+    uint8_t version = Mem24CSM01Schema<T>::version;
+    MEMORYRESULT result = update(address, &version, 1);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address++;
+  }
+  return (update(address, reinterpret_cast<const uint8_t *>(&value), sizeof(T)));
+}
+
+// Stores an object compared with the copy already stored, only the changed range of every page is written without reading the memory
+template <typename T>
+MEMORYRESULT Mem24CSM01::put(uint32_t address, const T &value, const T &previous)
+{
+  static_assert(__is_trivially_copyable(T), "put() stores the bytes of the object, the type must be trivially copyable");
+  static_assert(storedSize<T>() <= MEMORY_SIZE, "The type does not fit in the memory");
+  if (Mem24CSM01Schema<T>::version != 0)
+  {
+    address++; // The version byte has been written with the previous copy
+  }
+  return (updateFrom(address, reinterpret_cast<const uint8_t *>(&value), reinterpret_cast<const uint8_t *>(&previous), sizeof(T)));
+}
+
+// Reads an object stored with put(), MISMATCH if it was stored with another schema version
+template <typename T>
+MEMORYRESULT Mem24CSM01::get(uint32_t address, T &value)
+{
+  static_assert(__is_trivially_copyable(T), "get() reads the bytes of the object, the type must be trivially copyable");
+  static_assert(storedSize<T>() <= MEMORY_SIZE, "The type does not fit in the memory");
+  uint8_t version = 0;
+  ReadSegment segments[2] = {{&version, storedSize<T>() - sizeof(T)}, {reinterpret_cast<uint8_t *>(&value), sizeof(T)}};
+  MEMORYRESULT result = readv(address, segments, 2);
+  if (result == MEMORYRESULT::OK && version != Mem24CSM01Schema<T>::version)
+  {
+    result = MEMORYRESULT::MISMATCH;
+  }
+  return (result);
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,176 @@
+#include "MIC24CSM01Array.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Array class.
+ *
+ * @param chips Array of pointers to the chips, in address order. The pointers are copied.
+ * @param chipCount The number of chips, from 1 to MAX_ARRAY_CHIPS.
+ * @param mapping How the linear address space is mapped on the chips.
+ */
+Mem24CSM01Array::Mem24CSM01Array(Mem24CSM01 *const *chips, uint8_t chipCount, ARRAYMAPPING mapping)
+{
+  if (chipCount > MAX_ARRAY_CHIPS)
+  {
+    chipCount = MAX_ARRAY_CHIPS;
+  }
+  for (uint8_t i = 0; i < chipCount; ++i)
+  {
+    m_chips[i] = chips[i];
+  }
+  m_chip_count = chipCount;
+  m_mapping = mapping;
+}
+
+/**
+ * @brief Initializes every chip of the array.
+ *
+ * @param clock The I2C bus clock frequency in Hz, 0 keeps the Wire library default.
+ */
+void Mem24CSM01Array::begin(uint32_t clock)
+{
+  for (uint8_t i = 0; i < m_chip_count; ++i)
+  {
+    m_chips[i]->begin(clock);
+  }
+}
+
+/**
+ * @brief Returns the size of the linear address space.
+ *
+ * @return uint32_t The size in bytes, MEMORY_SIZE for every chip.
+ */
+uint32_t Mem24CSM01Array::size()
+{
+  return ((uint32_t)m_chip_count * MEMORY_SIZE);
+}
+
+/**
+ * @brief Reads data from the array, the read can span several chips.
+ *
+ * @param address The linear address to read from.
+ * @param buffer Pointer to the buffer where the read data will be stored.
+ * @param size The number of bytes to read.
+ * @return MEMORYRESULT::OK if the read operation is successful.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the array size.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the read does not fit between the address and the end of the array.
+ *         Other values indicating the result of the first failed chip read.
+ */
+MEMORYRESULT Mem24CSM01Array::read(uint32_t address, uint8_t *buffer, size_t size)
+{
+  if (address >= this->size())
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > this->size() - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  while (size > 0)
+  {
+    uint32_t chipAddress;
+    size_t chunkSize;
+    Mem24CSM01 *chip = locate(address, &chipAddress, &chunkSize);
+    if (chunkSize > size)
+    {
+      chunkSize = size;
+    }
+    MEMORYRESULT result = chip->read(chipAddress, buffer, chunkSize);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address += chunkSize;
+    buffer += chunkSize;
+    size -= chunkSize;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes data to the array, the write can span several chips.
+ *
+ * Every chip waits only for its own write cycle, so when the write moves to the next
+ * chip the previous one completes its write cycle in the meantime. With the striped
+ * mapping this happens at every page.
+ *
+ * @param address The linear address where the data will be written.
+ * @param dataArray A pointer to the array of data to be written.
+ * @param arraySize The size of the data array.
+ * @return MEMORYRESULT::OK if the write operation is successful.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the address is beyond the array size.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the write does not fit between the address and the end of the array.
+ *         Other values indicating the result of the first failed chip write.
+ */
+MEMORYRESULT Mem24CSM01Array::write(uint32_t address, const uint8_t *dataArray, size_t arraySize)
+{
+  if (address >= size())
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (arraySize > size() - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  while (arraySize > 0)
+  {
+    uint32_t chipAddress;
+    size_t chunkSize;
+    Mem24CSM01 *chip = locate(address, &chipAddress, &chunkSize);
+    if (chunkSize > arraySize)
+    {
+      chunkSize = arraySize;
+    }
+    MEMORYRESULT result = chip->writeBulk(chipAddress, dataArray, chunkSize);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address += chunkSize;
+    dataArray += chunkSize;
+    arraySize -= chunkSize;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Waits for the end of the write cycle of every chip.
+ *
+ * @return MEMORYRESULT::OK if all the chips are ready, MEMORYRESULT::TIMEOUT otherwise.
+ */
+MEMORYRESULT Mem24CSM01Array::waitForWriteCompletion()
+{
+  MEMORYRESULT result = MEMORYRESULT::OK;
+  for (uint8_t i = 0; i < m_chip_count; ++i)
+  {
+    if (m_chips[i]->waitForWriteCompletion() != MEMORYRESULT::OK)
+    {
+      result = MEMORYRESULT::TIMEOUT;
+    }
+  }
+  return (result);
+}
+
+/**
+ * @brief Maps a linear address on a chip.
+ *
+ * @param address The linear address, it must be lower than size().
+ * @param chipAddress Pointer where the address inside the chip is stored.
+ * @param contiguous Pointer where the number of bytes stored contiguously in the same chip is stored.
+ * @return Mem24CSM01* The chip holding the address.
+ */
+Mem24CSM01 *Mem24CSM01Array::locate(uint32_t address, uint32_t *chipAddress, size_t *contiguous)
+{
+  if (m_mapping == ARRAYMAPPING::ARRAY_STRIPED)
+  {
+    uint32_t page = address / MAX_MEMORY_PAGE_SIZE;
+    uint32_t offset = address % MAX_MEMORY_PAGE_SIZE;
+    *chipAddress = (page / m_chip_count) * MAX_MEMORY_PAGE_SIZE + offset;
+    *contiguous = MAX_MEMORY_PAGE_SIZE - offset;
+    return (m_chips[page % m_chip_count]);
+  }
+  *chipAddress = address % MEMORY_SIZE;
+  *contiguous = MEMORY_SIZE - *chipAddress;
+  return (m_chips[address / MEMORY_SIZE]);
+}
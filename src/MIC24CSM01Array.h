@@ -0,0 +1,50 @@
+/*
+  Mem24CSM01Array - Several Mem24CSM01 EEPROM chips addressed as one linear memory
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Array_h
+#define MIC24CSM01Array_h
+
+#include "MIC24CSM01.h"
+
+#define MAX_ARRAY_CHIPS 4 // The A1 and A2 pins allow up to four chips on the same bus
+
+/**
+ * @enum ARRAYMAPPING
+ * @brief How the linear address space is mapped on the chips of a Mem24CSM01Array.
+ *
+ * @var ARRAYMAPPING::ARRAY_LINEAR
+ * Every chip holds a contiguous 128 KiB window, chip 0 first.
+ *
+ * @var ARRAYMAPPING::ARRAY_STRIPED
+ * Consecutive pages are spread over the chips, page n is stored in chip n % chipCount.
+ * Consecutive page writes go to different chips, so each chip runs its write cycle
+ * while the next one is being written.
+ */
+typedef enum
+{
+  ARRAY_LINEAR,
+  ARRAY_STRIPED,
+} ARRAYMAPPING;
+
+class Mem24CSM01Array
+{
+public:
+  Mem24CSM01Array(Mem24CSM01 *const *chips, uint8_t chipCount, ARRAYMAPPING mapping = ARRAYMAPPING::ARRAY_LINEAR);
+  void begin(uint32_t clock = 0);
+  uint32_t size();
+
+  MEMORYRESULT read(uint32_t address, uint8_t *buffer, size_t size);
+  MEMORYRESULT write(uint32_t address, const uint8_t *dataArray, size_t arraySize);
+  MEMORYRESULT waitForWriteCompletion();
+
+private:
+  Mem24CSM01 *locate(uint32_t address, uint32_t *chipAddress, size_t *contiguous);
+  Mem24CSM01 *m_chips[MAX_ARRAY_CHIPS]; // Chips of the array
+  uint8_t m_chip_count;                 // Number of chips in the array
+  ARRAYMAPPING m_mapping;               // Mapping of the linear address space
+};
+
+#endif
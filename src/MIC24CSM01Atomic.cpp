@@ -0,0 +1,258 @@
+#include "MIC24CSM01Atomic.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Atomic class.
+ *
+ * The record is stored in two slots A and B used alternately. A save writes the payload
+ * in the slot not holding the current record, waits for the end of the write cycles and
+ * then writes the header of that slot: a power failure before the header write cycle
+ * completes leaves the previous record intact and still the newest valid one.
+ * The header holds a sequence number, the payload length, a CRC-32 of the payload and a
+ * CRC-16 of the header itself, so a half-written header is never taken for a record.
+ *
+ * @param memory The memory chip holding the record.
+ * @param baseAddress The address of the first slot, footprint() bytes are used from there.
+ * @param capacity The largest payload of the record.
+ */
+Mem24CSM01Atomic::Mem24CSM01Atomic(Mem24CSM01 &memory, uint32_t baseAddress, uint16_t capacity)
+{
+  m_memory = &memory;
+  m_base_address = baseAddress;
+  m_capacity = capacity;
+  m_slot_size = ((uint32_t)ATOMIC_HEADER_SIZE + capacity + ATOMIC_WORD_SIZE - 1) / ATOMIC_WORD_SIZE * ATOMIC_WORD_SIZE;
+  m_active = ATOMIC_NO_SLOT;
+  m_sequence = 0;
+  m_length = 0;
+  m_payload_crc = 0;
+}
+
+/**
+ * @brief Finds the newest valid record.
+ *
+ * Only the two headers are read, the payload CRC is checked by load().
+ *
+ * @return MEMORYRESULT::OK if the headers have been read, even if no record is valid
+ *         (see isEmpty()), otherwise the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Atomic::begin()
+{
+  m_active = ATOMIC_NO_SLOT;
+  for (uint8_t slot = 0; slot < 2; ++slot)
+  {
+    uint32_t sequence;
+    uint16_t length;
+    uint32_t payloadCrc;
+    bool valid;
+    MEMORYRESULT result = readHeader(slot, &sequence, &length, &payloadCrc, &valid);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    if (valid && (m_active == ATOMIC_NO_SLOT || (int32_t)(sequence - m_sequence) > 0)) // Newer even after a wrap around
+    {
+      m_active = slot;
+      m_sequence = sequence;
+      m_length = length;
+      m_payload_crc = payloadCrc;
+    }
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Replaces the record.
+ *
+ * The payload is written with writeBulk() in the slot not holding the current record,
+ * then the header is written once the payload write cycles are over. The function
+ * returns after the header write cycle, the new record is then committed.
+ *
+ * @param data The payload.
+ * @param size The payload size, up to the capacity.
+ * @return MEMORYRESULT OK when the record is committed, BUFFER_TOO_LARGE if the payload exceeds
+ *         the capacity, otherwise the result of the failed write, the previous record is kept.
+ */
+MEMORYRESULT Mem24CSM01Atomic::save(const uint8_t *data, size_t size)
+{
+  if (size > m_capacity)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  uint8_t slot = m_active == 0 ? 1 : 0;
+  uint32_t sequence = m_active == ATOMIC_NO_SLOT ? 0 : m_sequence + 1;
+  uint32_t payloadCrc = Mem24CSM01Crc::crc32(data, size);
+  MEMORYRESULT result = m_memory->writeBulk(slotAddress(slot) + ATOMIC_HEADER_SIZE, data, size);
+  if (result == MEMORYRESULT::OK)
+  {
+    result = m_memory->waitForWriteCompletion(); // The header must not be written before the payload is
+  }
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+
+  uint8_t header[ATOMIC_HEADER_SIZE];
+  header[0] = sequence & 0xFF;
+  header[1] = (sequence >> 8) & 0xFF;
+  header[2] = (sequence >> 16) & 0xFF;
+  header[3] = (sequence >> 24) & 0xFF;
+  header[4] = size & 0xFF;
+  header[5] = (size >> 8) & 0xFF;
+  Mem24CSM01Crc::store(CRCTYPE::CRC_32, payloadCrc, header + 6);
+  Mem24CSM01Crc::store(CRCTYPE::CRC_16, Mem24CSM01Crc::crc16(header, ATOMIC_HEADER_CRC_OFFSET), header + ATOMIC_HEADER_CRC_OFFSET);
+  result = m_memory->writeBulk(slotAddress(slot), header, sizeof(header));
+  if (result == MEMORYRESULT::OK)
+  {
+    result = m_memory->waitForWriteCompletion();
+  }
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  m_active = slot;
+  m_sequence = sequence;
+  m_length = size;
+  m_payload_crc = payloadCrc;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the newest record.
+ *
+ * The payload CRC is checked, if the newest slot has been corrupted after its commit the
+ * record of the other slot is returned when it is valid.
+ *
+ * @param buffer The buffer receiving the payload.
+ * @param bufferSize The size of the buffer.
+ * @param recordSize Optional pointer where the payload size is stored.
+ * @return MEMORYRESULT OK if a valid record has been read, NOT_FOUND if there is no record,
+ *         BUFFER_TOO_LARGE if the buffer is smaller than the payload, CRC_ERROR if no slot
+ *         holds a valid payload, otherwise the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Atomic::load(uint8_t *buffer, size_t bufferSize, size_t *recordSize)
+{
+  if (m_active == ATOMIC_NO_SLOT)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  MEMORYRESULT result = loadSlot(m_active, m_length, m_payload_crc, buffer, bufferSize);
+  size_t loaded = m_length;
+  if (result == MEMORYRESULT::CRC_ERROR) // Fall back on the previous record
+  {
+    uint32_t sequence;
+    uint16_t length;
+    uint32_t payloadCrc;
+    bool valid;
+    MEMORYRESULT headerResult = readHeader(m_active ^ 1, &sequence, &length, &payloadCrc, &valid);
+    if (headerResult != MEMORYRESULT::OK)
+    {
+      return (headerResult);
+    }
+    if (valid)
+    {
+      result = loadSlot(m_active ^ 1, length, payloadCrc, buffer, bufferSize);
+      loaded = length;
+    }
+  }
+  if (result == MEMORYRESULT::OK && recordSize != nullptr)
+  {
+    *recordSize = loaded;
+  }
+  return (result);
+}
+
+/**
+ * @brief Tells whether a valid record has been found by begin() or written by save().
+ *
+ * @return true if there is no record.
+ */
+bool Mem24CSM01Atomic::isEmpty()
+{
+  return (m_active == ATOMIC_NO_SLOT);
+}
+
+/**
+ * @brief Returns the payload size of the newest record.
+ *
+ * @return size_t The size, 0 if there is no record.
+ */
+size_t Mem24CSM01Atomic::size()
+{
+  return (m_active == ATOMIC_NO_SLOT ? 0 : m_length);
+}
+
+/**
+ * @brief Returns the sequence number of the newest record, incremented by every save().
+ *
+ * @return uint32_t The sequence number, 0 if there is no record.
+ */
+uint32_t Mem24CSM01Atomic::getSequence()
+{
+  return (m_active == ATOMIC_NO_SLOT ? 0 : m_sequence);
+}
+
+/**
+ * @brief Returns the memory used by the two slots.
+ *
+ * @return uint32_t The number of bytes from the base address.
+ */
+uint32_t Mem24CSM01Atomic::footprint()
+{
+  return (2 * m_slot_size);
+}
+
+uint32_t Mem24CSM01Atomic::slotAddress(uint8_t slot)
+{
+  return (m_base_address + slot * m_slot_size);
+}
+
+/**
+ * @brief Reads and checks the header of a slot.
+ *
+ * @param slot The slot, 0 or 1.
+ * @param sequence Pointer where the sequence number is stored.
+ * @param length Pointer where the payload length is stored.
+ * @param payloadCrc Pointer where the payload CRC is stored.
+ * @param valid Pointer set to true if the header CRC matches and the length fits in the slot.
+ * @return MEMORYRESULT The result of the read.
+ */
+MEMORYRESULT Mem24CSM01Atomic::readHeader(uint8_t slot, uint32_t *sequence, uint16_t *length, uint32_t *payloadCrc, bool *valid)
+{
+  uint8_t header[ATOMIC_HEADER_SIZE];
+  *valid = false;
+  MEMORYRESULT result = m_memory->read(slotAddress(slot), header, sizeof(header));
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  *sequence = header[0] | ((uint32_t)header[1] << 8) | ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+  *length = header[4] | (header[5] << 8);
+  *payloadCrc = Mem24CSM01Crc::load(CRCTYPE::CRC_32, header + 6);
+  uint16_t headerCrc = Mem24CSM01Crc::load(CRCTYPE::CRC_16, header + ATOMIC_HEADER_CRC_OFFSET);
+  *valid = headerCrc == Mem24CSM01Crc::crc16(header, ATOMIC_HEADER_CRC_OFFSET) && *length <= m_capacity;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the payload of a slot and checks its CRC.
+ *
+ * @param slot The slot, 0 or 1.
+ * @param length The payload length stored in the header.
+ * @param payloadCrc The payload CRC stored in the header.
+ * @param buffer The buffer receiving the payload.
+ * @param bufferSize The size of the buffer.
+ * @return MEMORYRESULT OK if the payload matches its CRC, CRC_ERROR if not, BUFFER_TOO_LARGE if
+ *         the buffer is too small, otherwise the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Atomic::loadSlot(uint8_t slot, uint16_t length, uint32_t payloadCrc, uint8_t *buffer, size_t bufferSize)
+{
+  if (length > bufferSize)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  MEMORYRESULT result = m_memory->read(slotAddress(slot) + ATOMIC_HEADER_SIZE, buffer, length);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  return (Mem24CSM01Crc::crc32(buffer, length) == payloadCrc ? MEMORYRESULT::OK : MEMORYRESULT::CRC_ERROR);
+}
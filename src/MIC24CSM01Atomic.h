@@ -0,0 +1,46 @@
+/*
+  Mem24CSM01Atomic - Power-fail safe record with two alternating slots on the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Atomic_h
+#define MIC24CSM01Atomic_h
+
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Crc.h"
+
+// Slot layout: header, then the payload
+// Header layout: 4 bytes sequence number, 2 bytes payload length, 4 bytes payload CRC-32, 2 bytes header CRC-16
+#define ATOMIC_HEADER_SIZE 12
+#define ATOMIC_HEADER_CRC_OFFSET 10 // The header CRC covers the bytes before it
+#define ATOMIC_WORD_SIZE 4          // The chip corrects errors on 4-byte words, the slots start on a word boundary
+#define ATOMIC_NO_SLOT 0xFF         // Active slot when neither slot holds a valid record
+
+class Mem24CSM01Atomic
+{
+public:
+  Mem24CSM01Atomic(Mem24CSM01 &memory, uint32_t baseAddress, uint16_t capacity);
+  MEMORYRESULT begin();
+  MEMORYRESULT save(const uint8_t *data, size_t size);
+  MEMORYRESULT load(uint8_t *buffer, size_t bufferSize, size_t *recordSize = nullptr);
+  bool isEmpty();
+  size_t size();
+  uint32_t getSequence();
+  uint32_t footprint();
+
+private:
+  uint32_t slotAddress(uint8_t slot);
+  MEMORYRESULT readHeader(uint8_t slot, uint32_t *sequence, uint16_t *length, uint32_t *payloadCrc, bool *valid);
+  MEMORYRESULT loadSlot(uint8_t slot, uint16_t length, uint32_t payloadCrc, uint8_t *buffer, size_t bufferSize);
+  Mem24CSM01 *m_memory;    // Memory chip holding the record
+  uint32_t m_base_address; // Address of the first slot
+  uint16_t m_capacity;     // Largest payload of a slot
+  uint32_t m_slot_size;    // Distance between the two slots
+  uint8_t m_active;        // Slot holding the newest valid record, ATOMIC_NO_SLOT if none
+  uint32_t m_sequence;     // Sequence number of the newest record
+  uint16_t m_length;       // Payload length of the newest record
+  uint32_t m_payload_crc;  // Payload CRC of the newest record
+};
+
+#endif
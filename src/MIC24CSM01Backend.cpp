@@ -0,0 +1,195 @@
+#include "MIC24CSM01Backend.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Backend class.
+ *
+ * Initializes the state of the default asynchronous transmission for every backend.
+ */
+Mem24CSM01Backend::Mem24CSM01Backend()
+{
+  m_transmission_result = 0;
+  m_transaction_count = 0;
+}
+
+/**
+ * @brief Ends the queued transmission with a stop condition, possibly in background.
+ *
+ * The default implementation sends the transmission before returning.
+ *
+ * @return true if the transmission has been started, its result is returned by getTransmissionResult().
+ */
+bool Mem24CSM01Backend::endTransmissionAsync()
+{
+  m_transmission_result = endTransmission(true);
+  return (true);
+}
+
+/**
+ * @brief Returns whether the transmission started by endTransmissionAsync() is still running.
+ *
+ * @return true while the transmission is running.
+ */
+bool Mem24CSM01Backend::isTransmissionPending()
+{
+  return (false);
+}
+
+/**
+ * @brief Returns the result of the transmission started by endTransmissionAsync().
+ *
+ * @return uint8_t The result, with the values of TwoWire::endTransmission().
+ */
+uint8_t Mem24CSM01Backend::getTransmissionResult()
+{
+  return (m_transmission_result);
+}
+
+/**
+ * @brief Counts a transaction started on the bus by a driver of the library.
+ *
+ * Every object using the backend counts its transactions here, so an adapter reading
+ * straight from the receive buffer, like Mem24CSM01Stream, knows when another chip or
+ * driver on the same bus has reused it.
+ */
+void Mem24CSM01Backend::countTransaction()
+{
+  m_transaction_count++;
+}
+
+/**
+ * @brief Returns the number of transactions started on the bus through the backend.
+ *
+ * @return uint32_t The counter, it wraps around.
+ */
+uint32_t Mem24CSM01Backend::getTransactionCount()
+{
+  return (m_transaction_count);
+}
+
+/**
+ * @brief Returns the time of the bus in microseconds.
+ *
+ * @return unsigned long The micros() value by default.
+ */
+unsigned long Mem24CSM01Backend::getMicros()
+{
+  return (micros());
+}
+
+/**
+ * @brief Returns the time of the bus in milliseconds.
+ *
+ * @return unsigned long The millis() value by default.
+ */
+unsigned long Mem24CSM01Backend::getMillis()
+{
+  return (millis());
+}
+
+/**
+ * @brief Waits on the time of the bus.
+ *
+ * @param duration The time to wait in microseconds.
+ */
+void Mem24CSM01Backend::delayMicros(uint32_t duration)
+{
+  if (duration >= 1000)
+  {
+    delay(duration / 1000); // delayMicroseconds() is accurate only up to a few milliseconds
+  }
+  delayMicroseconds(duration % 1000);
+}
+
+uint32_t Mem24CSM01WireBackend::s_wire_transaction_count = 0;
+
+/**
+ * @brief Constructor for the Mem24CSM01WireBackend class.
+ *
+ * @param wire The I2C bus the chip is connected to.
+ */
+Mem24CSM01WireBackend::Mem24CSM01WireBackend(TwoWire &wire)
+{
+  m_wire = &wire;
+}
+
+void Mem24CSM01WireBackend::begin()
+{
+  m_wire->begin();
+}
+
+void Mem24CSM01WireBackend::end()
+{
+  m_wire->end();
+}
+
+void Mem24CSM01WireBackend::setClock(uint32_t clock)
+{
+  m_wire->setClock(clock);
+}
+
+void Mem24CSM01WireBackend::beginTransmission(uint8_t deviceAddress)
+{
+  m_wire->beginTransmission(deviceAddress);
+}
+
+size_t Mem24CSM01WireBackend::write(uint8_t value)
+{
+  return (m_wire->write(value));
+}
+
+size_t Mem24CSM01WireBackend::write(const uint8_t *data, size_t size)
+{
+  return (m_wire->write(data, size));
+}
+
+uint8_t Mem24CSM01WireBackend::endTransmission(bool sendStop)
+{
+  return (m_wire->endTransmission(sendStop));
+}
+
+uint8_t Mem24CSM01WireBackend::requestFrom(uint8_t deviceAddress, uint8_t quantity)
+{
+  return (m_wire->requestFrom(deviceAddress, quantity, (uint8_t) true));
+}
+
+int Mem24CSM01WireBackend::read()
+{
+  return (m_wire->read());
+}
+
+int Mem24CSM01WireBackend::peek()
+{
+  return (m_wire->peek());
+}
+
+/**
+ * @brief Counts a transaction on the Wire buses.
+ *
+ * Every Mem24CSM01 object has its own Wire backend, the counter is shared by all of them
+ * so the chips on the same TwoWire see each other transactions. A transaction on another
+ * TwoWire is counted as well, it only makes a reader fetch its bytes again.
+ */
+void Mem24CSM01WireBackend::countTransaction()
+{
+  countWireTransaction();
+}
+
+/**
+ * @brief Returns the number of transactions started on the Wire buses by the library.
+ *
+ * The Wire transactions of code outside the library are not counted.
+ *
+ * @return uint32_t The counter, it wraps around.
+ */
+uint32_t Mem24CSM01WireBackend::getTransactionCount()
+{
+  return (s_wire_transaction_count);
+}
+
+/**
+ * @brief Counts a transaction of a driver using the Wire library without a backend, like Mem24CSM01T.
+ */
+void Mem24CSM01WireBackend::countWireTransaction()
+{
+  s_wire_transaction_count++;
+}
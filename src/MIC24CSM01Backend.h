@@ -0,0 +1,83 @@
+/*
+  Mem24CSM01Backend - I2C bus interface used by the Mem24CSM01 library
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Backend_h
+#define MIC24CSM01Backend_h
+
+#include <stdint.h>
+#include <Arduino.h>
+#include <Wire.h>
+
+/**
+ * @class Mem24CSM01Backend
+ * @brief I2C bus operations used by Mem24CSM01, with the same meaning as the TwoWire methods.
+ *
+ * A platform driver moving the page payloads with DMA or an interrupt driven FIFO derives
+ * from this class and overrides endTransmissionAsync(), isTransmissionPending() and
+ * getTransmissionResult(): the asynchronous write engine then starts the transfer of a page
+ * and returns, service() checks its completion at the next call. The default
+ * implementation of the asynchronous transfer is blocking.
+ * The backend is also the time source of the driver: the write cycle timing, the timeouts
+ * and the retry backoff use getMicros(), getMillis() and delayMicros(), which a simulated
+ * bus overrides with its own clock.
+ */
+class Mem24CSM01Backend
+{
+public:
+  Mem24CSM01Backend();
+  virtual ~Mem24CSM01Backend() {}
+  virtual void begin() = 0;
+  virtual void end() = 0;
+  virtual void setClock(uint32_t clock) = 0;
+  virtual void beginTransmission(uint8_t deviceAddress) = 0;
+  virtual size_t write(uint8_t value) = 0;
+  virtual size_t write(const uint8_t *data, size_t size) = 0;
+  virtual uint8_t endTransmission(bool sendStop = true) = 0;
+  virtual uint8_t requestFrom(uint8_t deviceAddress, uint8_t quantity) = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  virtual bool endTransmissionAsync();
+  virtual bool isTransmissionPending();
+  virtual uint8_t getTransmissionResult();
+  virtual void countTransaction();
+  virtual uint32_t getTransactionCount();
+  virtual unsigned long getMicros();
+  virtual unsigned long getMillis();
+  virtual void delayMicros(uint32_t duration);
+
+protected:
+  uint8_t m_transmission_result; // Result of the last transmission started with endTransmissionAsync()
+  uint32_t m_transaction_count;  // Transactions started through the backend
+};
+
+/**
+ * @class Mem24CSM01WireBackend
+ * @brief Portable backend using the blocking TwoWire calls of the Arduino Wire library.
+ */
+class Mem24CSM01WireBackend : public Mem24CSM01Backend
+{
+public:
+  Mem24CSM01WireBackend(TwoWire &wire);
+  void begin();
+  void end();
+  void setClock(uint32_t clock);
+  void beginTransmission(uint8_t deviceAddress);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *data, size_t size);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t deviceAddress, uint8_t quantity);
+  int read();
+  int peek();
+  void countTransaction();
+  uint32_t getTransactionCount();
+  static void countWireTransaction();
+
+private:
+  TwoWire *m_wire;                          // I2C bus the chip is connected to
+  static uint32_t s_wire_transaction_count; // Transactions started on the Wire buses by every driver of the library
+};
+
+#endif
@@ -0,0 +1,294 @@
+#include "MIC24CSM01Batch.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Batch class.
+ *
+ * The records are appended one after the other in a memory region, like a raw log.
+ * They are collected in a RAM buffer and written with a single page write when the
+ * buffer reaches the end of a MEM24CSM01_BATCH_SIZE block, so a node logging a few
+ * bytes per wake-up pays one write cycle per block instead of one per record.
+ * The buffer is written by the asynchronous write engine of the memory while a second
+ * buffer collects the next records, the MCU can sleep during the write cycle for the
+ * time returned by getIdleTime().
+ * The records staged in RAM are lost on a power failure, setDeadline() bounds how long
+ * they can stay there and flush() writes them before a power down.
+ *
+ * @param memory The memory chip receiving the records.
+ * @param address The address of the first record.
+ * @param size The size of the region in bytes, clipped to the end of the memory.
+ */
+Mem24CSM01Batch::Mem24CSM01Batch(Mem24CSM01 &memory, uint32_t address, uint32_t size)
+{
+  m_memory = &memory;
+  m_address = address < MEMORY_SIZE ? address : MEMORY_SIZE;
+  m_end_address = size < MEMORY_SIZE - m_address ? m_address + size : MEMORY_SIZE;
+  m_fill = 0;
+  m_staged = 0;
+  m_result = MEMORYRESULT::OK;
+  m_committing = false;
+  m_deadline = BATCH_NO_DEADLINE;
+  m_staged_since = 0;
+}
+
+/**
+ * @brief Appends a record to the batch.
+ *
+ * The record is copied in RAM, the memory is written only when the buffer is full.
+ * A record reaching the end of the buffer continues in the second buffer, at that
+ * point the full buffer is committed and the function needs the previous commit
+ * to be over.
+ *
+ * @param record The record bytes.
+ * @param size The record size, up to MEM24CSM01_BATCH_SIZE.
+ * @return MEMORYRESULT::OK if the record has been staged.
+ *         MEMORYRESULT::BUSY if the record needs a commit while the asynchronous write engine is busy,
+ *         nothing is staged, call service() or wait getIdleTime() and try again.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the record is larger than MEM24CSM01_BATCH_SIZE or the region is full.
+ *         Otherwise the error of the commit started by the record, the bytes of the failed commit are dropped.
+ */
+MEMORYRESULT Mem24CSM01Batch::append(const uint8_t *record, size_t size)
+{
+  if (size > MEM24CSM01_BATCH_SIZE || size > available())
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  progress();
+  size_t room = bufferLimit() - m_staged;
+  if (size > room && (m_committing || m_memory->getWriteStatus() == MEMORYRESULT::BUSY))
+  {
+    return (MEMORYRESULT::BUSY);
+  }
+  if (m_staged == 0 && size > 0)
+  {
+    m_staged_since = m_memory->getBackend()->getMillis();
+  }
+  size_t head = size < room ? size : room;
+  memcpy(&m_buffers[m_fill][m_staged], record, head);
+  m_staged += head;
+  if (m_staged == bufferLimit())
+  {
+    MEMORYRESULT result = commit();
+    if (result == MEMORYRESULT::BUSY)
+    {
+      return (MEMORYRESULT::OK); // The record fitted in the buffer, service() commits it later
+    }
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+  }
+  if (head < size)
+  {
+    m_staged_since = m_memory->getBackend()->getMillis();
+    memcpy(m_buffers[m_fill], record + head, size - head);
+    m_staged = size - head;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Starts the write of the staged records without waiting for the buffer to be full.
+ *
+ * The write is executed by the asynchronous write engine of the memory, service()
+ * must be called until it completes.
+ *
+ * @return MEMORYRESULT::OK if the write has been started or nothing is staged.
+ *         MEMORYRESULT::BUSY if the asynchronous write engine is busy.
+ *         Otherwise the error returned by Mem24CSM01::beginWrite(), the staged bytes are dropped.
+ */
+MEMORYRESULT Mem24CSM01Batch::commit()
+{
+  progress();
+  if (m_committing || m_memory->getWriteStatus() == MEMORYRESULT::BUSY)
+  {
+    return (MEMORYRESULT::BUSY);
+  }
+  if (m_staged == 0)
+  {
+    return (MEMORYRESULT::OK);
+  }
+  MEMORYRESULT result = m_memory->beginWrite(m_address, m_buffers[m_fill], m_staged);
+  m_address += m_staged;
+  m_staged = 0;
+  if (result != MEMORYRESULT::OK)
+  {
+    m_result = result;
+    return (result);
+  }
+  m_fill ^= 1; // The committed buffer belongs to the engine until the write completes
+  m_committing = true;
+  m_result = MEMORYRESULT::BUSY;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes the staged records and waits for the end of the write cycles.
+ *
+ * To be called before a power down, the records are then in the memory.
+ *
+ * @return MEMORYRESULT::OK if all the records are written, BUSY if the asynchronous write
+ *         engine is used by another write, otherwise the error of the failed write.
+ */
+MEMORYRESULT Mem24CSM01Batch::flush()
+{
+  while (m_committing)
+  {
+    progress();
+  }
+  MEMORYRESULT result = commit();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  while (m_committing)
+  {
+    progress();
+  }
+  if (m_result != MEMORYRESULT::OK)
+  {
+    return (m_result);
+  }
+  return (m_memory->waitForWriteCompletion());
+}
+
+/**
+ * @brief Advances the running commit and commits the buffer when it is full or its deadline has passed.
+ *
+ * Must be called periodically, e.g. after every wake-up. Each call performs at most
+ * one step of the asynchronous write engine, see Mem24CSM01::service().
+ *
+ * @return MEMORYRESULT::BUSY while a commit is running, otherwise the result of the last commit.
+ */
+MEMORYRESULT Mem24CSM01Batch::service()
+{
+  progress();
+  if (m_committing)
+  {
+    return (MEMORYRESULT::BUSY);
+  }
+  if (m_staged > 0 && (m_staged == bufferLimit() || (m_deadline != BATCH_NO_DEADLINE && m_memory->getBackend()->getMillis() - m_staged_since >= m_deadline)))
+  {
+    MEMORYRESULT result = commit();
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+  }
+  return (m_result);
+}
+
+/**
+ * @brief Sets how long a record can stay in RAM before it is committed by service().
+ *
+ * @param milliseconds The maximum time between the first staged record and its commit, BATCH_NO_DEADLINE to commit full buffers only.
+ */
+void Mem24CSM01Batch::setDeadline(uint32_t milliseconds)
+{
+  m_deadline = milliseconds;
+}
+
+/**
+ * @brief Returns how long the MCU can sleep before service() has something to do.
+ *
+ * During a commit this is the worst case time left of the write cycle, so the chip is
+ * not polled while it cannot answer. Otherwise it is the time left before the deadline
+ * of the staged records.
+ *
+ * @return The idle time in microseconds, 0 if service() must be called now,
+ *         BATCH_IDLE_FOREVER if nothing has to be done before the next append().
+ */
+uint32_t Mem24CSM01Batch::getIdleTime()
+{
+  if (m_committing)
+  {
+    return (m_memory->getWriteCycleRemaining()); // 0 also while a page is waiting to be sent
+  }
+  if (m_staged == 0)
+  {
+    return (BATCH_IDLE_FOREVER);
+  }
+  if (m_staged == bufferLimit())
+  {
+    return (0);
+  }
+  if (m_deadline == BATCH_NO_DEADLINE)
+  {
+    return (BATCH_IDLE_FOREVER);
+  }
+  unsigned long elapsed = m_memory->getBackend()->getMillis() - m_staged_since;
+  if (elapsed >= m_deadline)
+  {
+    return (0);
+  }
+  uint32_t left = m_deadline - elapsed;
+  if (left >= BATCH_IDLE_FOREVER / 1000)
+  {
+    return (BATCH_IDLE_FOREVER - 1); // Wake up and ask again
+  }
+  return (left * 1000);
+}
+
+/**
+ * @brief Returns the bytes staged in RAM and not yet committed.
+ *
+ * @return The number of staged bytes.
+ */
+size_t Mem24CSM01Batch::pending()
+{
+  return (m_staged);
+}
+
+/**
+ * @brief Returns the address of the next record.
+ *
+ * @return The address where the next appended record will be written.
+ */
+uint32_t Mem24CSM01Batch::getAddress()
+{
+  return (m_address + m_staged);
+}
+
+/**
+ * @brief Returns the free space of the region.
+ *
+ * @return The number of bytes that can still be appended.
+ */
+uint32_t Mem24CSM01Batch::available()
+{
+  return (m_end_address - m_address - m_staged);
+}
+
+/**
+ * @brief Returns the capacity of the filling buffer.
+ *
+ * The buffer ends on a MEM24CSM01_BATCH_SIZE boundary, so every commit after the first
+ * one of a block stays on a single page, or at the end of the region.
+ *
+ * @return The number of bytes the filling buffer can hold.
+ */
+size_t Mem24CSM01Batch::bufferLimit()
+{
+  uint32_t limit = MEM24CSM01_BATCH_SIZE - m_address % MEM24CSM01_BATCH_SIZE;
+  if (limit > m_end_address - m_address)
+  {
+    limit = m_end_address - m_address;
+  }
+  return (limit);
+}
+
+/**
+ * @brief Advances the running commit by one step of the asynchronous write engine.
+ */
+void Mem24CSM01Batch::progress()
+{
+  if (!m_committing)
+  {
+    return;
+  }
+  MEMORYRESULT result = m_memory->service();
+  if (result != MEMORYRESULT::BUSY)
+  {
+    m_committing = false;
+    m_result = result;
+  }
+}
@@ -0,0 +1,59 @@
+/*
+  Mem24CSM01Batch - Batched writes of small records to the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Batch_h
+#define MIC24CSM01Batch_h
+
+#include "MIC24CSM01.h"
+
+// Size of each of the two RAM buffers, a power of two dividing the page size so the commits stay on page boundaries
+#ifndef MEM24CSM01_BATCH_SIZE
+#if MEM24CSM01_WRITE_CHUNK_SIZE >= 256
+#define MEM24CSM01_BATCH_SIZE 256
+#elif MEM24CSM01_WRITE_CHUNK_SIZE >= 128
+#define MEM24CSM01_BATCH_SIZE 128
+#elif MEM24CSM01_WRITE_CHUNK_SIZE >= 64
+#define MEM24CSM01_BATCH_SIZE 64
+#elif MEM24CSM01_WRITE_CHUNK_SIZE >= 32
+#define MEM24CSM01_BATCH_SIZE 32
+#else
+#define MEM24CSM01_BATCH_SIZE 16
+#endif
+#endif
+
+#define BATCH_NO_DEADLINE 0           // Deadline value keeping the records in RAM until the buffer is full
+#define BATCH_IDLE_FOREVER 0xFFFFFFFF // Idle time when nothing has to be done before the next append()
+
+class Mem24CSM01Batch
+{
+public:
+  Mem24CSM01Batch(Mem24CSM01 &memory, uint32_t address, uint32_t size);
+  MEMORYRESULT append(const uint8_t *record, size_t size);
+  MEMORYRESULT commit();
+  MEMORYRESULT flush();
+  MEMORYRESULT service();
+  void setDeadline(uint32_t milliseconds);
+  uint32_t getIdleTime();
+  size_t pending();
+  uint32_t getAddress();
+  uint32_t available();
+
+private:
+  size_t bufferLimit();
+  void progress();
+  Mem24CSM01 *m_memory;                          // Memory chip receiving the records
+  uint32_t m_end_address;                        // Address after the last byte of the region
+  uint32_t m_address;                            // Address of the first byte of the filling buffer
+  uint8_t m_buffers[2][MEM24CSM01_BATCH_SIZE];   // The filling buffer and the buffer being committed
+  uint8_t m_fill;                                // Index of the filling buffer
+  size_t m_staged;                               // Bytes in the filling buffer
+  MEMORYRESULT m_result;                         // Result of the last commit, BUSY while running
+  bool m_committing;                             // True while the other buffer is written by the async engine
+  uint32_t m_deadline;                           // Maximum time in milliseconds a record stays in RAM, BATCH_NO_DEADLINE if none
+  unsigned long m_staged_since;                  // Bus time in milliseconds when the first byte of the filling buffer was staged
+};
+
+#endif
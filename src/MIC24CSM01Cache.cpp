@@ -0,0 +1,340 @@
+#include "MIC24CSM01Cache.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Cache class.
+ *
+ * The cache keeps MEM24CSM01_CACHE_PAGES pages in RAM. Reads are served from the cached
+ * pages, writes only change the cached copy and flush() programs every changed page
+ * with a single page write. Writes done directly through the Mem24CSM01 object are not
+ * seen by the cache, call invalidate() after them.
+ *
+ * @param memory The memory chip behind the cache.
+ */
+Mem24CSM01Cache::Mem24CSM01Cache(Mem24CSM01 &memory)
+{
+  m_memory = &memory;
+  m_use_counter = 0;
+  invalidate();
+}
+
+/**
+ * @brief Reads a single byte through the cache.
+ *
+ * @param address The memory address to read from.
+ * @param data Pointer to a variable where the read byte will be stored.
+ * @return MEMORYRESULT The result of the read operation.
+ */
+MEMORYRESULT Mem24CSM01Cache::read(uint32_t address, uint8_t *data)
+{
+  return (read(address, data, 1));
+}
+
+/**
+ * @brief Reads data through the cache.
+ *
+ * Cached pages are copied from RAM, missing pages are loaded in the cache. Reads larger
+ * than the whole cache bypass it for the pages not already cached, so that a long
+ * sequential read does not evict the pages in use.
+ *
+ * @param address The memory address to read from.
+ * @param buffer Pointer to the buffer where the read data will be stored.
+ * @param size The number of bytes to read.
+ * @return MEMORYRESULT The result of the read operation.
+ */
+MEMORYRESULT Mem24CSM01Cache::read(uint32_t address, uint8_t *buffer, size_t size)
+{
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  bool allocate = size <= (size_t)MEM24CSM01_CACHE_PAGES * MAX_MEMORY_PAGE_SIZE;
+  while (size > 0)
+  {
+    uint32_t pageAddress = address - (address % MAX_MEMORY_PAGE_SIZE);
+    size_t offset = address - pageAddress;
+    size_t chunkSize = MAX_MEMORY_PAGE_SIZE - offset;
+    if (chunkSize > size)
+    {
+      chunkSize = size;
+    }
+
+    MEMORYRESULT result = MEMORYRESULT::OK;
+    CachePage *page = findPage(pageAddress);
+    if (page == nullptr && allocate)
+    {
+      page = loadPage(pageAddress, true, &result);
+    }
+    if (page != nullptr)
+    {
+      memcpy(buffer, page->data + offset, chunkSize);
+    }
+    else if (result == MEMORYRESULT::OK)
+    {
+      result = m_memory->read(address, buffer, chunkSize);
+    }
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    address += chunkSize;
+    buffer += chunkSize;
+    size -= chunkSize;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes a single byte in the cache.
+ *
+ * @param address The memory address to write.
+ * @param singleByte The byte value to be written.
+ * @return MEMORYRESULT The result of the write operation.
+ */
+MEMORYRESULT Mem24CSM01Cache::write(uint32_t address, uint8_t singleByte)
+{
+  return (write(address, &singleByte, 1));
+}
+
+/**
+ * @brief Writes data in the cache.
+ *
+ * The data is copied in the cached pages and only the bytes whose value changes are
+ * marked dirty. Missing pages are loaded first, unless the write covers the whole page:
+ * such a page is then marked dirty entirely.
+ * When a page must be evicted its changes are written to the memory.
+ * The pages in write protected zones are skipped like Mem24CSM01::writeBulk() does, they
+ * are never cached as dirty since they could not be flushed.
+ *
+ * @param address The memory address where the data will be written.
+ * @param dataArray A pointer to the array of data to be written.
+ * @param arraySize The size of the data array.
+ * @return MEMORYRESULT The result of the write operation, WRITE_PROTECTED if part of the data
+ *         is in write protected zones, the rest has been cached.
+ */
+MEMORYRESULT Mem24CSM01Cache::write(uint32_t address, const uint8_t *dataArray, size_t arraySize)
+{
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (arraySize > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  bool skipped = false; // True when protected pages have been skipped
+  while (arraySize > 0)
+  {
+    uint32_t pageAddress = address - (address % MAX_MEMORY_PAGE_SIZE);
+    size_t offset = address - pageAddress;
+    size_t chunkSize = MAX_MEMORY_PAGE_SIZE - offset;
+    if (chunkSize > arraySize)
+    {
+      chunkSize = arraySize;
+    }
+
+    if (m_memory->protectedSize(address, chunkSize) > 0) // A page is never split between two zones
+    {
+      skipped = true;
+      address += chunkSize;
+      dataArray += chunkSize;
+      arraySize -= chunkSize;
+      continue;
+    }
+
+    MEMORYRESULT result = MEMORYRESULT::OK;
+    bool stale = false; // True when the page is loaded without reading the memory
+    CachePage *page = findPage(pageAddress);
+    if (page == nullptr)
+    {
+      stale = chunkSize == MAX_MEMORY_PAGE_SIZE;
+      page = loadPage(pageAddress, !stale, &result);
+      if (page == nullptr)
+      {
+        return (result);
+      }
+    }
+
+    if (stale) // The page holds the bytes of the evicted page, a comparison would miss changes
+    {
+      memcpy(page->data, dataArray, MAX_MEMORY_PAGE_SIZE);
+      page->dirtyStart = 0;
+      page->dirtyEnd = MAX_MEMORY_PAGE_SIZE;
+    }
+    for (size_t i = 0; i < chunkSize && !stale; ++i)
+    {
+      size_t position = offset + i;
+      if (page->data[position] == dataArray[i])
+      {
+        continue; // Unchanged bytes are not written again
+      }
+      page->data[position] = dataArray[i];
+      if (page->dirtyStart == page->dirtyEnd) // First change since the last flush
+      {
+        page->dirtyStart = position;
+        page->dirtyEnd = position + 1;
+      }
+      else if (position < page->dirtyStart)
+      {
+        page->dirtyStart = position;
+      }
+      else if (position >= page->dirtyEnd)
+      {
+        page->dirtyEnd = position + 1;
+      }
+    }
+    address += chunkSize;
+    dataArray += chunkSize;
+    arraySize -= chunkSize;
+  }
+  return (skipped ? MEMORYRESULT::WRITE_PROTECTED : MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes every changed page to the memory.
+ *
+ * Each dirty page is programmed with a single page write covering the range from the
+ * first to the last changed byte.
+ *
+ * @return MEMORYRESULT The result of the first failed page write, MEMORYRESULT::OK otherwise.
+ */
+MEMORYRESULT Mem24CSM01Cache::flush()
+{
+  MEMORYRESULT result = MEMORYRESULT::OK;
+  for (uint8_t i = 0; i < MEM24CSM01_CACHE_PAGES; ++i)
+  {
+    MEMORYRESULT pageResult = flushPage(&m_pages[i]);
+    if (result == MEMORYRESULT::OK)
+    {
+      result = pageResult;
+    }
+  }
+  return (result);
+}
+
+/**
+ * @brief Drops every cached page, the changes not flushed are lost.
+ */
+void Mem24CSM01Cache::invalidate()
+{
+  for (uint8_t i = 0; i < MEM24CSM01_CACHE_PAGES; ++i)
+  {
+    m_pages[i].valid = false;
+    m_pages[i].dirtyStart = 0;
+    m_pages[i].dirtyEnd = 0;
+    m_pages[i].lastUse = 0;
+  }
+}
+
+/**
+ * @brief Checks whether some changes are not written to the memory yet.
+ *
+ * @return true if at least one cached page is dirty.
+ */
+bool Mem24CSM01Cache::isDirty()
+{
+  for (uint8_t i = 0; i < MEM24CSM01_CACHE_PAGES; ++i)
+  {
+    if (m_pages[i].valid && m_pages[i].dirtyStart != m_pages[i].dirtyEnd)
+    {
+      return (true);
+    }
+  }
+  return (false);
+}
+
+/**
+ * @brief Looks for a page in the cache.
+ *
+ * @param pageAddress Address of the first byte of the page.
+ * @return CachePage* The cached page, nullptr if the page is not cached.
+ */
+CachePage *Mem24CSM01Cache::findPage(uint32_t pageAddress)
+{
+  for (uint8_t i = 0; i < MEM24CSM01_CACHE_PAGES; ++i)
+  {
+    if (m_pages[i].valid && m_pages[i].pageAddress == pageAddress)
+    {
+      m_pages[i].lastUse = ++m_use_counter;
+      return (&m_pages[i]);
+    }
+  }
+  return (nullptr);
+}
+
+/**
+ * @brief Loads a page in the cache, evicting the least recently used page.
+ *
+ * @param pageAddress Address of the first byte of the page.
+ * @param fetch true to read the page content from the memory, false when it is going to be overwritten.
+ * @param result Pointer where the result of the eviction and of the page read is stored.
+ * @return CachePage* The loaded page, nullptr on error.
+ */
+CachePage *Mem24CSM01Cache::loadPage(uint32_t pageAddress, bool fetch, MEMORYRESULT *result)
+{
+  CachePage *page = &m_pages[0];
+  for (uint8_t i = 0; i < MEM24CSM01_CACHE_PAGES; ++i)
+  {
+    if (!m_pages[i].valid)
+    {
+      page = &m_pages[i];
+      break;
+    }
+    if ((uint16_t)(m_use_counter - m_pages[i].lastUse) > (uint16_t)(m_use_counter - page->lastUse))
+    {
+      page = &m_pages[i];
+    }
+  }
+
+  *result = flushPage(page);
+  if (*result != MEMORYRESULT::OK)
+  {
+    return (nullptr);
+  }
+  page->valid = false;
+  if (fetch)
+  {
+    *result = m_memory->read(pageAddress, page->data, MAX_MEMORY_PAGE_SIZE);
+    if (*result != MEMORYRESULT::OK)
+    {
+      return (nullptr);
+    }
+  }
+  page->pageAddress = pageAddress;
+  page->valid = true;
+  page->dirtyStart = 0;
+  page->dirtyEnd = 0;
+  page->lastUse = ++m_use_counter;
+  return (page);
+}
+
+/**
+ * @brief Writes the changed range of a page to the memory.
+ *
+ * A page whose zone has been protected after it was cached can never be written, it is
+ * dropped so the error is reported once and the cache can still evict it.
+ *
+ * @param page The cached page.
+ * @return MEMORYRESULT The result of the page write, MEMORYRESULT::OK if the page is clean.
+ */
+MEMORYRESULT Mem24CSM01Cache::flushPage(CachePage *page)
+{
+  if (!page->valid || page->dirtyStart == page->dirtyEnd)
+  {
+    return (MEMORYRESULT::OK);
+  }
+  MEMORYRESULT result = m_memory->writeBulk(page->pageAddress + page->dirtyStart, page->data + page->dirtyStart,
+                                            page->dirtyEnd - page->dirtyStart);
+  if (result == MEMORYRESULT::OK || result == MEMORYRESULT::WRITE_PROTECTED)
+  {
+    page->valid = result == MEMORYRESULT::OK; // The copy of a protected page differs from the memory
+    page->dirtyStart = 0;
+    page->dirtyEnd = 0;
+  }
+  return (result);
+}
@@ -0,0 +1,71 @@
+/*
+  Mem24CSM01Cache - Write-back page cache for the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Cache_h
+#define MIC24CSM01Cache_h
+
+#include "MIC24CSM01.h"
+
+// Number of pages kept in RAM, every page uses MAX_MEMORY_PAGE_SIZE bytes plus a few bytes of state
+#ifndef MEM24CSM01_CACHE_PAGES
+#define MEM24CSM01_CACHE_PAGES 1
+#endif
+
+/**
+ * @struct CachePage
+ * @brief A memory page kept in RAM by Mem24CSM01Cache.
+ *
+ * @var CachePage::pageAddress
+ * Address of the first byte of the page.
+ *
+ * @var CachePage::valid
+ * true when the page holds a copy of the memory page.
+ *
+ * @var CachePage::dirtyStart
+ * Offset of the first byte changed since the last flush.
+ *
+ * @var CachePage::dirtyEnd
+ * Offset after the last byte changed since the last flush, equal to dirtyStart when the page is clean.
+ *
+ * @var CachePage::lastUse
+ * Value of the cache use counter at the last access, used to evict the least recently used page.
+ *
+ * @var CachePage::data
+ * The page content.
+ */
+typedef struct
+{
+  uint32_t pageAddress;
+  bool valid;
+  uint16_t dirtyStart;
+  uint16_t dirtyEnd;
+  uint16_t lastUse;
+  uint8_t data[MAX_MEMORY_PAGE_SIZE];
+} CachePage;
+
+class Mem24CSM01Cache
+{
+public:
+  Mem24CSM01Cache(Mem24CSM01 &memory);
+
+  MEMORYRESULT read(uint32_t address, uint8_t *data);
+  MEMORYRESULT read(uint32_t address, uint8_t *buffer, size_t size);
+  MEMORYRESULT write(uint32_t address, uint8_t singleByte);
+  MEMORYRESULT write(uint32_t address, const uint8_t *dataArray, size_t arraySize);
+  MEMORYRESULT flush();
+  void invalidate();
+  bool isDirty();
+
+private:
+  CachePage *findPage(uint32_t pageAddress);
+  CachePage *loadPage(uint32_t pageAddress, bool fetch, MEMORYRESULT *result);
+  MEMORYRESULT flushPage(CachePage *page);
+  Mem24CSM01 *m_memory;                      // Memory chip behind the cache
+  CachePage m_pages[MEM24CSM01_CACHE_PAGES]; // Cached pages
+  uint16_t m_use_counter;                    // Incremented at every page access
+};
+
+#endif
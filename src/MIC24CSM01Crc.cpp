@@ -0,0 +1,147 @@
+#include "MIC24CSM01Crc.h"
+#include <Arduino.h>
+
+#ifdef MEM24CSM01_ROM_CRC
+#include <esp_rom_crc.h>
+#endif
+
+// Tables of the byte-wise CRC kernels, generated by the compiler from the polynomials
+#if defined(__AVR__)
+#define MEM24CSM01_CRC_TABLE_STORAGE PROGMEM // The tables stay in flash, 1.5 KiB of SRAM saved
+#define CRC16_TABLE_ENTRY(index) pgm_read_word(&crc16Table[index])
+#define CRC32_TABLE_ENTRY(index) pgm_read_dword(&crc32Table[index])
+#else
+#define MEM24CSM01_CRC_TABLE_STORAGE
+#define CRC16_TABLE_ENTRY(index) crc16Table[index]
+#define CRC32_TABLE_ENTRY(index) crc32Table[index]
+#endif
+
+namespace
+{
+  // One shift of the CRC register, repeated for the 8 bits of the table index (C++11 constexpr)
+  constexpr uint16_t crc16Shift(uint16_t crc, uint8_t bits)
+  {
+    return (bits == 0 ? crc : crc16Shift((crc & 0x8000) ? (uint16_t)((crc << 1) ^ MEM24CSM01_CRC16_POLYNOMIAL) : (uint16_t)(crc << 1), bits - 1));
+  }
+
+  constexpr uint32_t crc32Shift(uint32_t crc, uint8_t bits)
+  {
+    return (bits == 0 ? crc : crc32Shift((crc & 1) ? (crc >> 1) ^ MEM24CSM01_CRC32_POLYNOMIAL : (crc >> 1), bits - 1));
+  }
+}
+
+#define CRC16_ENTRY(index) crc16Shift((uint16_t)((index) << 8), 8)
+#define CRC32_ENTRY(index) crc32Shift((uint32_t)(index), 8)
+#define CRC_ROW(entry, row) entry(row + 0), entry(row + 1), entry(row + 2), entry(row + 3), entry(row + 4), entry(row + 5), entry(row + 6), entry(row + 7), \
+                            entry(row + 8), entry(row + 9), entry(row + 10), entry(row + 11), entry(row + 12), entry(row + 13), entry(row + 14), entry(row + 15)
+#define CRC_TABLE(entry) CRC_ROW(entry, 0x00), CRC_ROW(entry, 0x10), CRC_ROW(entry, 0x20), CRC_ROW(entry, 0x30), \
+                         CRC_ROW(entry, 0x40), CRC_ROW(entry, 0x50), CRC_ROW(entry, 0x60), CRC_ROW(entry, 0x70), \
+                         CRC_ROW(entry, 0x80), CRC_ROW(entry, 0x90), CRC_ROW(entry, 0xA0), CRC_ROW(entry, 0xB0), \
+                         CRC_ROW(entry, 0xC0), CRC_ROW(entry, 0xD0), CRC_ROW(entry, 0xE0), CRC_ROW(entry, 0xF0)
+
+static const uint16_t crc16Table[256] MEM24CSM01_CRC_TABLE_STORAGE = {CRC_TABLE(CRC16_ENTRY)};
+
+#ifndef MEM24CSM01_ROM_CRC
+static const uint32_t crc32Table[256] MEM24CSM01_CRC_TABLE_STORAGE = {CRC_TABLE(CRC32_ENTRY)};
+#endif
+
+/**
+ * @brief Computes the CRC-16/CCITT-FALSE of a block.
+ *
+ * @param data Pointer to the data.
+ * @param size The number of bytes.
+ * @param crc The result of the previous block to continue a computation, MEM24CSM01_CRC16_INIT to start one.
+ * @return uint16_t The CRC of the data.
+ */
+uint16_t Mem24CSM01Crc::crc16(const uint8_t *data, size_t size, uint16_t crc)
+{
+  while (size-- > 0)
+  {
+    crc = (crc << 8) ^ CRC16_TABLE_ENTRY((uint8_t)(crc >> 8) ^ *data++);
+  }
+  return (crc);
+}
+
+/**
+ * @brief Computes the CRC-32 of a block.
+ *
+ * On the ESP32 the ROM routine is used.
+ *
+ * @param data Pointer to the data.
+ * @param size The number of bytes.
+ * @param crc The result of the previous block to continue a computation, MEM24CSM01_CRC32_INIT to start one.
+ * @return uint32_t The CRC of the data.
+ */
+uint32_t Mem24CSM01Crc::crc32(const uint8_t *data, size_t size, uint32_t crc)
+{
+#ifdef MEM24CSM01_ROM_CRC
+  return (esp_rom_crc32_le(crc, data, size));
+#else
+  crc = ~crc;
+  while (size-- > 0)
+  {
+    crc = (crc >> 8) ^ CRC32_TABLE_ENTRY((uint8_t)crc ^ *data++);
+  }
+  return (~crc);
+#endif
+}
+
+/**
+ * @brief Computes the CRC of a block.
+ *
+ * @param type The CRC to compute.
+ * @param data Pointer to the data.
+ * @param size The number of bytes.
+ * @return uint32_t The CRC of the data.
+ */
+uint32_t Mem24CSM01Crc::compute(CRCTYPE type, const uint8_t *data, size_t size)
+{
+  if (type == CRCTYPE::CRC_32)
+  {
+    return (crc32(data, size));
+  }
+  return (crc16(data, size));
+}
+
+/**
+ * @brief Returns the size of a CRC.
+ *
+ * @param type The CRC.
+ * @return uint8_t The number of bytes stored in memory.
+ */
+uint8_t Mem24CSM01Crc::size(CRCTYPE type)
+{
+  return (type == CRCTYPE::CRC_32 ? 4 : 2);
+}
+
+/**
+ * @brief Converts a CRC to the little endian bytes stored in memory.
+ *
+ * @param type The CRC.
+ * @param crc The value.
+ * @param bytes Pointer to a buffer of size(type) bytes.
+ */
+void Mem24CSM01Crc::store(CRCTYPE type, uint32_t crc, uint8_t *bytes)
+{
+  for (uint8_t i = 0; i < size(type); ++i)
+  {
+    bytes[i] = (uint8_t)(crc >> (8 * i));
+  }
+}
+
+/**
+ * @brief Converts the little endian bytes stored in memory to a CRC.
+ *
+ * @param type The CRC.
+ * @param bytes Pointer to a buffer of size(type) bytes.
+ * @return uint32_t The value.
+ */
+uint32_t Mem24CSM01Crc::load(CRCTYPE type, const uint8_t *bytes)
+{
+  uint32_t crc = 0;
+  for (uint8_t i = 0; i < size(type); ++i)
+  {
+    crc |= (uint32_t)bytes[i] << (8 * i);
+  }
+  return (crc);
+}
@@ -0,0 +1,52 @@
+/*
+  Mem24CSM01Crc - CRC kernels used by the Mem24CSM01 integrity layer
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Crc_h
+#define MIC24CSM01Crc_h
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define MEM24CSM01_CRC16_POLYNOMIAL 0x1021     // CRC-16/CCITT-FALSE, not reflected
+#define MEM24CSM01_CRC16_INIT 0xFFFF           // CRC-16/CCITT-FALSE initial value
+#define MEM24CSM01_CRC32_POLYNOMIAL 0xEDB88320 // CRC-32 (IEEE 802.3), reflected
+#define MEM24CSM01_CRC32_INIT 0x00000000       // CRC-32 of an empty block, used to start a computation
+
+// The ESP32 cores expose the CRC routines of the ROM, they are used instead of the tables
+#if defined(ARDUINO_ARCH_ESP32) && defined(__has_include)
+#if __has_include(<esp_rom_crc.h>)
+#define MEM24CSM01_ROM_CRC
+#endif
+#endif
+
+/**
+ * @enum CRCTYPE
+ * @brief Checksum appended to a block by the integrity layer.
+ *
+ * @var CRCTYPE::CRC_16
+ * CRC-16/CCITT-FALSE, 2 bytes.
+ *
+ * @var CRCTYPE::CRC_32
+ * CRC-32 (IEEE 802.3), 4 bytes.
+ */
+typedef enum
+{
+  CRC_16,
+  CRC_32,
+} CRCTYPE;
+
+class Mem24CSM01Crc
+{
+public:
+  static uint16_t crc16(const uint8_t *data, size_t size, uint16_t crc = MEM24CSM01_CRC16_INIT);
+  static uint32_t crc32(const uint8_t *data, size_t size, uint32_t crc = MEM24CSM01_CRC32_INIT);
+  static uint32_t compute(CRCTYPE type, const uint8_t *data, size_t size);
+  static uint8_t size(CRCTYPE type);
+  static void store(CRCTYPE type, uint32_t crc, uint8_t *bytes);
+  static uint32_t load(CRCTYPE type, const uint8_t *bytes);
+};
+
+#endif
@@ -0,0 +1,471 @@
+#include "MIC24CSM01KeyValue.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01KeyValue class.
+ *
+ * The store is an open addressing hash table. The index holds a 16-bit fingerprint for
+ * each entry, e.g. 256 entries fit in two pages, and entry i owns the data slot i stored
+ * after the index. A lookup reads the index entries along the probe sequence, usually
+ * only one, and then the data slot, which stores the key so that two keys with the same
+ * hash are told apart. With a cache the index pages stay in RAM and the updates are
+ * coalesced in page writes until flush().
+ *
+ * @param memory The memory chip holding the store.
+ * @param baseAddress The address of the index, better page aligned.
+ * @param capacity The maximum number of keys, at least 1.
+ * @param slotSize The size of a data slot, at least KV_SLOT_HEADER_SIZE, the largest value is slotSize - KV_SLOT_HEADER_SIZE - key length bytes.
+ * @param cache Optional write-back cache over the same memory chip.
+ */
+Mem24CSM01KeyValue::Mem24CSM01KeyValue(Mem24CSM01 &memory, uint32_t baseAddress, uint16_t capacity, uint8_t slotSize, Mem24CSM01Cache *cache)
+{
+  m_memory = &memory;
+  m_cache = cache;
+  m_base_address = baseAddress;
+  m_capacity = capacity;
+  m_slot_size = slotSize;
+}
+
+/**
+ * @brief Checks the layout given to the constructor.
+ *
+ * get() and put() check it as well, the store needs no other initialization.
+ *
+ * @return MEMORYRESULT::OK if the store can be used.
+ *         MEMORYRESULT::INVALID_PARAMETER if the capacity is 0 or the slot size is smaller than KV_SLOT_HEADER_SIZE.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the index and the data slots do not fit in the memory.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::begin()
+{
+  if (m_capacity == 0 || m_slot_size < KV_SLOT_HEADER_SIZE)
+  {
+    return (MEMORYRESULT::INVALID_PARAMETER);
+  }
+  if (m_base_address > MEMORY_SIZE || size() > MEMORY_SIZE - m_base_address)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Erases every key of the store.
+ *
+ * Only the index is erased, the data slots are left as they are.
+ *
+ * @return MEMORYRESULT The result of the write.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::format()
+{
+  uint8_t erased[MEM24CSM01_COMPARE_CHUNK_SIZE];
+  memset(erased, 0xFF, sizeof(erased));
+  uint32_t indexSize = (uint32_t)m_capacity * KV_ENTRY_SIZE;
+  for (uint32_t offset = 0; offset < indexSize; offset += sizeof(erased))
+  {
+    size_t chunkSize = indexSize - offset;
+    if (chunkSize > sizeof(erased))
+    {
+      chunkSize = sizeof(erased);
+    }
+    MEMORYRESULT result = writeBytes(m_base_address + offset, erased, chunkSize);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the value of a key.
+ *
+ * After the index entries, the slot header, the key and the value are read with a single
+ * read of up to bufferSize value bytes, the bytes after the value are read as well.
+ *
+ * @param key The key, a null terminated string of up to MEM24CSM01_KV_MAX_KEY_LENGTH characters.
+ * @param buffer Pointer to the buffer where the value will be stored.
+ * @param bufferSize The size of the buffer.
+ * @param valueSize Optional pointer where the size of the value is stored.
+ * @return MEMORYRESULT::OK if the value has been read.
+ *         MEMORYRESULT::NOT_FOUND if the key does not exist.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the value does not fit in the buffer, the buffer content is undefined,
+ *         or if the key is longer than MEM24CSM01_KV_MAX_KEY_LENGTH.
+ *         Other values indicating the result of begin() or of the failed read.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::get(const char *key, uint8_t *buffer, size_t bufferSize, size_t *valueSize)
+{
+  MEMORYRESULT result = begin();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  size_t keyLength = strlen(key);
+  if (keyLength > MEM24CSM01_KV_MAX_KEY_LENGTH)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  if (keyLength > (size_t)(m_slot_size - KV_SLOT_HEADER_SIZE))
+  {
+    return (MEMORYRESULT::NOT_FOUND); // The key cannot be stored in a slot
+  }
+  size_t prefetch = m_slot_size - KV_SLOT_HEADER_SIZE - keyLength;
+  if (prefetch > bufferSize)
+  {
+    prefetch = bufferSize;
+  }
+  uint16_t index;
+  bool found;
+  uint8_t size;
+  result = find(key, keyLength, &index, &found, &size, buffer, prefetch);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  if (!found)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  if (size > prefetch)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  if (valueSize != nullptr)
+  {
+    *valueSize = size;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Writes the value of a key, the key is added if it does not exist.
+ *
+ * The data slot is written before the index entry, so an interrupted insert leaves the key missing.
+ * The slot header, the key and the value are written with a single write cycle when they share a page.
+ *
+ * @param key The key, a null terminated string of up to MEM24CSM01_KV_MAX_KEY_LENGTH characters.
+ * @param value A pointer to the value.
+ * @param valueSize The size of the value, up to slotSize - KV_SLOT_HEADER_SIZE - key length bytes.
+ * @return MEMORYRESULT::OK if the value has been written.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the key is too long, the key and the value do not fit in a slot or the store is full.
+ *         Other values indicating the result of begin() or of the failed read or write.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::put(const char *key, const uint8_t *value, size_t valueSize)
+{
+  MEMORYRESULT result = begin();
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  size_t keyLength = strlen(key);
+  if (keyLength > MEM24CSM01_KV_MAX_KEY_LENGTH || keyLength + valueSize > (size_t)(m_slot_size - KV_SLOT_HEADER_SIZE))
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  uint32_t hash = hashKey(key);
+  uint16_t index;
+  bool found;
+  result = find(key, keyLength, &index, &found);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  if (index == m_capacity) // No free entry along the probe sequence
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  uint8_t header[KV_SLOT_HEADER_SIZE] = {(uint8_t)hash, (uint8_t)(hash >> 8), (uint8_t)(hash >> 16), (uint8_t)(hash >> 24), (uint8_t)keyLength, (uint8_t)valueSize};
+  result = writeSlot(index, header, key, keyLength, value, valueSize);
+  if (result == MEMORYRESULT::OK && !found)
+  {
+    result = writeEntry(index, fingerprint(hash));
+  }
+  return (result);
+}
+
+/**
+ * @brief Removes a key.
+ *
+ * @param key The key, a null terminated string.
+ * @return MEMORYRESULT::OK if the key has been removed.
+ *         MEMORYRESULT::NOT_FOUND if the key does not exist.
+ *         Other values indicating the result of the failed read or write.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::remove(const char *key)
+{
+  size_t keyLength = strlen(key);
+  if (keyLength > MEM24CSM01_KV_MAX_KEY_LENGTH)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  uint16_t index;
+  bool found;
+  MEMORYRESULT result = find(key, keyLength, &index, &found);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  if (!found)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  return (writeEntry(index, KV_DELETED_ENTRY));
+}
+
+/**
+ * @brief Writes the pending changes when the store uses a cache.
+ *
+ * @return MEMORYRESULT The result of the cache flush, MEMORYRESULT::OK without a cache.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::flush()
+{
+  if (m_cache == nullptr)
+  {
+    return (MEMORYRESULT::OK);
+  }
+  return (m_cache->flush());
+}
+
+/**
+ * @brief Returns the memory used by the store.
+ *
+ * @return uint32_t The size in bytes of the index and of the data slots.
+ */
+uint32_t Mem24CSM01KeyValue::size()
+{
+  return ((uint32_t)m_capacity * (KV_ENTRY_SIZE + m_slot_size));
+}
+
+/**
+ * @brief Computes the 32-bit FNV-1a hash of a key.
+ *
+ * @param key The key, a null terminated string.
+ * @return uint32_t The hash of the key.
+ */
+uint32_t Mem24CSM01KeyValue::hashKey(const char *key)
+{
+  uint32_t hash = 2166136261UL;
+  while (*key != '\0')
+  {
+    hash ^= (uint8_t)*key++;
+    hash *= 16777619UL;
+  }
+  return (hash);
+}
+
+/**
+ * @brief Computes the index fingerprint of a key hash.
+ *
+ * @param hash The hash of the key.
+ * @return uint16_t The fingerprint, never KV_EMPTY_ENTRY or KV_DELETED_ENTRY.
+ */
+uint16_t Mem24CSM01KeyValue::fingerprint(uint32_t hash)
+{
+  uint16_t value = (hash >> 16) ^ (hash & 0xFFFF);
+  if (value == KV_EMPTY_ENTRY || value == KV_DELETED_ENTRY)
+  {
+    value = 1;
+  }
+  return (value);
+}
+
+/**
+ * @brief Looks for a key along its linear probe sequence.
+ *
+ * An entry whose fingerprint matches is confirmed with the full hash and the key stored in
+ * its data slot, the value is read with the slot header and the key when a buffer is given.
+ *
+ * @param key The key.
+ * @param keyLength The length of the key, up to MEM24CSM01_KV_MAX_KEY_LENGTH.
+ * @param index Pointer where the entry of the key is stored when found, otherwise the first
+ *              free entry where it can be inserted, or the capacity if the store is full.
+ * @param found Pointer where true is stored if the key exists.
+ * @param length Optional pointer where the value length stored in the slot of the key is stored.
+ * @param value Optional buffer filled with the first valueSize bytes of the slot value.
+ * @param valueSize The number of value bytes to read.
+ * @return MEMORYRESULT The result of the reads.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::find(const char *key, size_t keyLength, uint16_t *index, bool *found, uint8_t *length, uint8_t *value, size_t valueSize)
+{
+  uint32_t hash = hashKey(key);
+  uint16_t target = fingerprint(hash);
+  *index = m_capacity;
+  *found = false;
+  for (uint16_t probe = 0; probe < m_capacity; ++probe)
+  {
+    uint16_t position = (hash + probe) % m_capacity;
+    uint16_t entry;
+    MEMORYRESULT result = readEntry(position, &entry);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    if (entry == KV_EMPTY_ENTRY || entry == KV_DELETED_ENTRY)
+    {
+      if (*index == m_capacity)
+      {
+        *index = position; // First free entry, the key is inserted here if it does not exist
+      }
+      if (entry == KV_EMPTY_ENTRY)
+      {
+        break; // The probe sequence of the key ends at the first never used entry
+      }
+      continue;
+    }
+    if (entry == target)
+    {
+      uint8_t header[KV_SLOT_HEADER_SIZE];
+      uint8_t storedKey[MEM24CSM01_KV_MAX_KEY_LENGTH];
+      result = readSlot(position, header, storedKey, keyLength, value, value != nullptr ? valueSize : 0);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      uint32_t storedHash = (uint32_t)header[0] | ((uint32_t)header[1] << 8) | ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+      if (storedHash == hash && header[4] == keyLength && memcmp(storedKey, key, keyLength) == 0)
+      {
+        *index = position;
+        *found = true;
+        if (length != nullptr)
+        {
+          *length = header[KV_SLOT_HEADER_SIZE - 1];
+        }
+        break;
+      }
+    }
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads an index entry.
+ *
+ * @param index The entry number.
+ * @param entry Pointer where the fingerprint is stored.
+ * @return MEMORYRESULT The result of the read.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::readEntry(uint16_t index, uint16_t *entry)
+{
+  uint8_t bytes[KV_ENTRY_SIZE];
+  MEMORYRESULT result = readBytes(m_base_address + (uint32_t)index * KV_ENTRY_SIZE, bytes, KV_ENTRY_SIZE);
+  *entry = bytes[0] | (bytes[1] << 8);
+  return (result);
+}
+
+/**
+ * @brief Writes an index entry.
+ *
+ * @param index The entry number.
+ * @param entry The fingerprint.
+ * @return MEMORYRESULT The result of the write.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::writeEntry(uint16_t index, uint16_t entry)
+{
+  uint8_t bytes[KV_ENTRY_SIZE] = {(uint8_t)(entry & 0xFF), (uint8_t)(entry >> 8)};
+  return (writeBytes(m_base_address + (uint32_t)index * KV_ENTRY_SIZE, bytes, KV_ENTRY_SIZE));
+}
+
+/**
+ * @brief Returns the address of a data slot.
+ *
+ * @param index The slot number.
+ * @return uint32_t The address of the first byte of the slot.
+ */
+uint32_t Mem24CSM01KeyValue::slotAddress(uint16_t index)
+{
+  return (m_base_address + (uint32_t)m_capacity * KV_ENTRY_SIZE + (uint32_t)index * m_slot_size);
+}
+
+/**
+ * @brief Reads the header of a data slot, its key and the beginning of its value.
+ *
+ * The caller does not know the length of the stored key yet, the key and the value are read
+ * as if it were keyLength, the header tells whether they are valid.
+ * Without a cache the header, the key and the value are read with a single readv().
+ *
+ * @param index The slot number.
+ * @param header Buffer of KV_SLOT_HEADER_SIZE bytes filled with the slot header.
+ * @param key Buffer filled with the keyLength bytes following the header.
+ * @param keyLength The number of key bytes to read.
+ * @param value Buffer filled with the first valueSize bytes of the value, unused if valueSize is 0.
+ * @param valueSize The number of value bytes to read.
+ * @return MEMORYRESULT The result of the read.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::readSlot(uint16_t index, uint8_t *header, uint8_t *key, size_t keyLength, uint8_t *value, size_t valueSize)
+{
+  uint32_t address = slotAddress(index);
+  if (m_cache != nullptr)
+  {
+    MEMORYRESULT result = m_cache->read(address, header, KV_SLOT_HEADER_SIZE);
+    if (result == MEMORYRESULT::OK)
+    {
+      result = m_cache->read(address + KV_SLOT_HEADER_SIZE, key, keyLength);
+    }
+    if (result == MEMORYRESULT::OK && valueSize > 0)
+    {
+      result = m_cache->read(address + KV_SLOT_HEADER_SIZE + keyLength, value, valueSize);
+    }
+    return (result);
+  }
+  ReadSegment segments[3] = {{header, KV_SLOT_HEADER_SIZE}, {key, keyLength}, {value, valueSize}};
+  return (m_memory->readv(address, segments, valueSize > 0 ? 3 : 2));
+}
+
+/**
+ * @brief Writes the header, the key and the value of a data slot.
+ *
+ * A slot within a page is written with a single writev(), the header, the key and the
+ * value are programmed by the same write cycle. A slot crossing a page boundary is written
+ * key and value first and header last, so an interrupted write never leaves the new
+ * lengths with the old key or value.
+ *
+ * @param index The slot number.
+ * @param header The slot header, KV_SLOT_HEADER_SIZE bytes.
+ * @param key The key.
+ * @param keyLength The length of the key.
+ * @param value The value.
+ * @param valueSize The size of the value.
+ * @return MEMORYRESULT The result of the write.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::writeSlot(uint16_t index, const uint8_t *header, const char *key, size_t keyLength, const uint8_t *value, size_t valueSize)
+{
+  uint32_t address = slotAddress(index);
+  if (m_cache == nullptr && address % MAX_MEMORY_PAGE_SIZE + KV_SLOT_HEADER_SIZE + keyLength + valueSize <= MAX_MEMORY_PAGE_SIZE)
+  {
+    WriteSegment segments[3] = {{header, KV_SLOT_HEADER_SIZE}, {(const uint8_t *)key, keyLength}, {value, valueSize}};
+    return (m_memory->writev(address, segments, 3));
+  }
+  MEMORYRESULT result = writeBytes(address + KV_SLOT_HEADER_SIZE, (const uint8_t *)key, keyLength);
+  if (result == MEMORYRESULT::OK)
+  {
+    result = writeBytes(address + KV_SLOT_HEADER_SIZE + keyLength, value, valueSize);
+  }
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  return (writeBytes(address, header, KV_SLOT_HEADER_SIZE));
+}
+
+/**
+ * @brief Reads bytes through the cache when available.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::readBytes(uint32_t address, uint8_t *buffer, size_t size)
+{
+  if (m_cache != nullptr)
+  {
+    return (m_cache->read(address, buffer, size));
+  }
+  return (m_memory->read(address, buffer, size));
+}
+
+/**
+ * @brief Writes bytes through the cache when available, otherwise only the changed bytes are written.
+ */
+MEMORYRESULT Mem24CSM01KeyValue::writeBytes(uint32_t address, const uint8_t *data, size_t size)
+{
+  if (m_cache != nullptr)
+  {
+    return (m_cache->write(address, data, size));
+  }
+  return (m_memory->update(address, data, size));
+}
@@ -0,0 +1,55 @@
+/*
+  Mem24CSM01KeyValue - Key-value store with an on-chip hash index for the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01KeyValue_h
+#define MIC24CSM01KeyValue_h
+
+#include "MIC24CSM01.h"
+#include "MIC24CSM01Cache.h"
+
+// Index entry: 16-bit fingerprint of the key hash
+// Data slot layout: 4 bytes key hash, 1 byte key length, 1 byte value length, key, value
+#define KV_ENTRY_SIZE 2
+#define KV_SLOT_HEADER_SIZE 6
+#define KV_EMPTY_ENTRY 0xFFFF   // Fingerprint of an entry never used (erased memory)
+#define KV_DELETED_ENTRY 0x0000 // Fingerprint of a removed entry
+
+// Longest key, the key read back from a slot is compared in a stack buffer of this size
+#ifndef MEM24CSM01_KV_MAX_KEY_LENGTH
+#define MEM24CSM01_KV_MAX_KEY_LENGTH 32
+#endif
+
+class Mem24CSM01KeyValue
+{
+public:
+  Mem24CSM01KeyValue(Mem24CSM01 &memory, uint32_t baseAddress, uint16_t capacity, uint8_t slotSize, Mem24CSM01Cache *cache = nullptr);
+  MEMORYRESULT begin();
+  MEMORYRESULT format();
+  MEMORYRESULT get(const char *key, uint8_t *buffer, size_t bufferSize, size_t *valueSize = nullptr);
+  MEMORYRESULT put(const char *key, const uint8_t *value, size_t valueSize);
+  MEMORYRESULT remove(const char *key);
+  MEMORYRESULT flush();
+  uint32_t size();
+
+private:
+  static uint32_t hashKey(const char *key);
+  static uint16_t fingerprint(uint32_t hash);
+  MEMORYRESULT find(const char *key, size_t keyLength, uint16_t *index, bool *found, uint8_t *length = nullptr, uint8_t *value = nullptr, size_t valueSize = 0);
+  MEMORYRESULT readEntry(uint16_t index, uint16_t *entry);
+  MEMORYRESULT writeEntry(uint16_t index, uint16_t entry);
+  uint32_t slotAddress(uint16_t index);
+  MEMORYRESULT readSlot(uint16_t index, uint8_t *header, uint8_t *key, size_t keyLength, uint8_t *value, size_t valueSize);
+  MEMORYRESULT writeSlot(uint16_t index, const uint8_t *header, const char *key, size_t keyLength, const uint8_t *value, size_t valueSize);
+  MEMORYRESULT readBytes(uint32_t address, uint8_t *buffer, size_t size);
+  MEMORYRESULT writeBytes(uint32_t address, const uint8_t *data, size_t size);
+  Mem24CSM01 *m_memory;     // Memory chip holding the store
+  Mem24CSM01Cache *m_cache; // Optional write-back cache used for every access, can be nullptr
+  uint32_t m_base_address;  // Address of the index, the data slots follow it
+  uint16_t m_capacity;      // Number of entries of the index and of data slots
+  uint8_t m_slot_size;      // Size of a data slot, header included
+};
+
+#endif
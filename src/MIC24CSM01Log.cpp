@@ -0,0 +1,451 @@
+#include "MIC24CSM01Log.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Log class.
+ *
+ * The log appends records to a ring of pages. Every page starts with a sequence number
+ * incremented at every new page, so no header page is ever rewritten and every page
+ * is written once per lap of the ring. When the ring is full the oldest page is reused.
+ *
+ * @param memory The memory chip holding the log.
+ * @param firstPage The first page of the ring (address / MAX_MEMORY_PAGE_SIZE).
+ * @param pageCount The number of pages of the ring, at least LOG_MIN_PAGE_COUNT, checked by begin().
+ * @param recordSize The size of every record for fixed size records, 0 for variable size records.
+ */
+Mem24CSM01Log::Mem24CSM01Log(Mem24CSM01 &memory, uint16_t firstPage, uint16_t pageCount, uint8_t recordSize)
+{
+  m_memory = &memory;
+  m_first_page = firstPage;
+  m_page_count = pageCount;
+  m_record_size = recordSize;
+  m_started = false;
+  m_head_page = 0;
+  m_head_offset = LOG_PAGE_HEADER_SIZE;
+  m_last_offset = 0;
+  m_head_sequence = 0;
+}
+
+/**
+ * @brief Finds the head of the log.
+ *
+ * The pages written in the current lap hold consecutive sequence numbers starting from the
+ * sequence number of the first page of the ring, so the head page is found with a binary
+ * search reading O(log pageCount) page headers. The free space of the head page is then
+ * found with a second binary search over the record slots for fixed size records, or
+ * walking the records in windows of LOG_SCAN_WINDOW_SIZE bytes for variable size records.
+ * With the default buffer sizes the whole boot scan takes less than twenty short reads,
+ * whatever the size of the ring.
+ *
+ * @return MEMORYRESULT::OK if the log is ready.
+ *         MEMORYRESULT::INVALID_PARAMETER if the ring has less than LOG_MIN_PAGE_COUNT pages.
+ *         MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT if the ring does not fit in the memory.
+ *         Otherwise the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Log::begin()
+{
+  if (m_page_count < LOG_MIN_PAGE_COUNT)
+  {
+    return (MEMORYRESULT::INVALID_PARAMETER);
+  }
+  if ((uint32_t)m_first_page + m_page_count > MEMORY_SIZE / MAX_MEMORY_PAGE_SIZE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  m_started = false;
+  m_head_page = 0;
+  m_head_offset = LOG_PAGE_HEADER_SIZE;
+  m_last_offset = 0;
+  m_head_sequence = 0;
+
+  uint32_t firstSequence;
+  MEMORYRESULT result = readSequence(0, &firstSequence);
+  if (result != MEMORYRESULT::OK || firstSequence == LOG_ERASED_SEQUENCE)
+  {
+    return (result); // Empty log
+  }
+
+  uint16_t low = 0;             // Last page known to belong to the current lap
+  uint16_t high = m_page_count; // First page known not to belong to the current lap
+  while (high - low > 1)
+  {
+    uint16_t middle = low + (high - low) / 2;
+    uint32_t sequence;
+    result = readSequence(middle, &sequence);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    if (sequence != LOG_ERASED_SEQUENCE && sequence - firstSequence == middle)
+    {
+      low = middle;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+
+  m_head_page = low;
+  m_head_sequence = firstSequence + low;
+  result = m_record_size != 0 ? findSlotEnd(low, m_head_sequence) : findPageEnd(low, m_head_sequence);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  m_started = true;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Appends a record to the log.
+ *
+ * The record is written with a single write operation: in the head page if it fits in
+ * the free space, otherwise at the beginning of the next page together with the new
+ * page sequence number.
+ *
+ * @param record A pointer to the record data.
+ * @param size The size of the record, equal to the record size for fixed size records.
+ * @return MEMORYRESULT::OK if the record has been written.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the size is 0, larger than LOG_MAX_RECORD_SIZE or different from the fixed record size.
+ *         MEMORYRESULT::INVALID_PARAMETER if the ring has less than LOG_MIN_PAGE_COUNT pages.
+ *         Other values indicating the result of the write.
+ */
+MEMORYRESULT Mem24CSM01Log::append(const uint8_t *record, size_t size)
+{
+  if (m_page_count < LOG_MIN_PAGE_COUNT)
+  {
+    return (MEMORYRESULT::INVALID_PARAMETER);
+  }
+  if (size == 0 || size > LOG_MAX_RECORD_SIZE || (m_record_size != 0 && size != m_record_size))
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+
+  uint8_t header[LOG_PAGE_HEADER_SIZE + LOG_RECORD_HEADER_SIZE]; // Page header when a page starts, record header
+  uint8_t headerSize = 0;
+  uint16_t page = m_head_page;
+  uint16_t offset = m_head_offset;
+  uint32_t sequence = m_head_sequence;
+  if (!m_started || offset + LOG_RECORD_HEADER_SIZE + size > MAX_MEMORY_PAGE_SIZE) // Start a new page
+  {
+    if (m_started)
+    {
+      page = (page + 1) % m_page_count;
+      sequence++;
+    }
+    offset = 0;
+    header[headerSize++] = sequence & 0xFF;
+    header[headerSize++] = (sequence >> 8) & 0xFF;
+    header[headerSize++] = (sequence >> 16) & 0xFF;
+    header[headerSize++] = (sequence >> 24) & 0xFF;
+  }
+  header[headerSize++] = size;
+  header[headerSize++] = sequence & 0xFF;
+  header[headerSize++] = (sequence >> 8) & 0xFF;
+  uint16_t end = offset + headerSize + size;
+  static const uint8_t endMarker = LOG_END_OF_PAGE; // Older records of the page are not read back
+  WriteSegment segments[3] = {{header, headerSize}, {record, size}, {&endMarker, end < MAX_MEMORY_PAGE_SIZE ? 1u : 0u}};
+
+  MEMORYRESULT result = m_memory->writev(pageAddress(page) + offset, segments, 3);
+  if (result != MEMORYRESULT::OK)
+  {
+    return (result);
+  }
+  m_started = true;
+  m_head_page = page;
+  m_last_offset = end - size - LOG_RECORD_HEADER_SIZE;
+  m_head_offset = end;
+  m_head_sequence = sequence;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Sets a cursor on the oldest record of the log.
+ *
+ * @param cursor Pointer to the cursor to initialize.
+ * @return MEMORYRESULT::OK if the cursor is set.
+ *         MEMORYRESULT::NOT_FOUND if the log is empty.
+ *         Other values indicating the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Log::rewind(LogCursor *cursor)
+{
+  if (!m_started)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  cursor->page = 0;
+  cursor->offset = LOG_PAGE_HEADER_SIZE;
+  cursor->sequence = m_head_sequence - m_head_page;
+
+  uint16_t oldest = (m_head_page + 1) % m_page_count;
+  if (oldest != 0) // The oldest page is after the head page when the ring has wrapped
+  {
+    uint32_t sequence;
+    MEMORYRESULT result = readSequence(oldest, &sequence);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    if (sequence == m_head_sequence - m_page_count + 1)
+    {
+      cursor->page = oldest;
+      cursor->sequence = sequence;
+    }
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads the record at the cursor and moves the cursor to the next record.
+ *
+ * @param cursor Pointer to a cursor set by rewind().
+ * @param buffer Pointer to the buffer where the record will be stored.
+ * @param bufferSize The size of the buffer.
+ * @param recordSize Pointer where the size of the record is stored.
+ * @return MEMORYRESULT::OK if a record has been read.
+ *         MEMORYRESULT::NOT_FOUND if there are no more records.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the record does not fit in the buffer, the cursor is not moved.
+ *         Other values indicating the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Log::next(LogCursor *cursor, uint8_t *buffer, size_t bufferSize, size_t *recordSize)
+{
+  while (true)
+  {
+    uint8_t header[LOG_RECORD_HEADER_SIZE];
+    MEMORYRESULT result = MEMORYRESULT::OK;
+    bool valid = false;
+    if (cursor->offset + LOG_RECORD_HEADER_SIZE < MAX_MEMORY_PAGE_SIZE)
+    {
+      result = m_memory->read(pageAddress(cursor->page) + cursor->offset, header, LOG_RECORD_HEADER_SIZE);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      valid = isRecordValid(header, cursor->sequence, cursor->offset);
+    }
+
+    if (valid)
+    {
+      if (header[0] > bufferSize)
+      {
+        return (MEMORYRESULT::BUFFER_TOO_LARGE);
+      }
+      result = m_memory->read(pageAddress(cursor->page) + cursor->offset + LOG_RECORD_HEADER_SIZE, buffer, header[0]);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      *recordSize = header[0];
+      cursor->offset += LOG_RECORD_HEADER_SIZE + header[0];
+      return (MEMORYRESULT::OK);
+    }
+
+    if (cursor->sequence == m_head_sequence) // End of the head page
+    {
+      return (MEMORYRESULT::NOT_FOUND);
+    }
+    cursor->page = (cursor->page + 1) % m_page_count;
+    cursor->offset = LOG_PAGE_HEADER_SIZE;
+    cursor->sequence++;
+  }
+}
+
+/**
+ * @brief Reads the newest record of the log.
+ *
+ * The position of the newest record is known since begin(), so this costs a single read.
+ *
+ * @param buffer Pointer to the buffer where the record will be stored.
+ * @param bufferSize The size of the buffer.
+ * @param recordSize Pointer where the size of the record is stored.
+ * @return MEMORYRESULT::OK if the record has been read.
+ *         MEMORYRESULT::NOT_FOUND if the log is empty.
+ *         MEMORYRESULT::BUFFER_TOO_LARGE if the record does not fit in the buffer.
+ *         Other values indicating the result of the failed read.
+ */
+MEMORYRESULT Mem24CSM01Log::latest(uint8_t *buffer, size_t bufferSize, size_t *recordSize)
+{
+  if (!m_started || m_last_offset == 0)
+  {
+    return (MEMORYRESULT::NOT_FOUND);
+  }
+  size_t size = m_head_offset - m_last_offset - LOG_RECORD_HEADER_SIZE;
+  if (size > bufferSize)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  *recordSize = size;
+  return (m_memory->read(pageAddress(m_head_page) + m_last_offset + LOG_RECORD_HEADER_SIZE, buffer, size));
+}
+
+/**
+ * @brief Erases the log.
+ *
+ * The sequence number of every page is invalidated, this costs one write cycle per page.
+ *
+ * @return MEMORYRESULT::OK if the log has been erased, otherwise the result of the failed write.
+ */
+MEMORYRESULT Mem24CSM01Log::clear()
+{
+  const uint8_t erased[LOG_PAGE_HEADER_SIZE] = {0xFF, 0xFF, 0xFF, 0xFF};
+  for (uint16_t page = 0; page < m_page_count; ++page)
+  {
+    MEMORYRESULT result = m_memory->writeBulk(pageAddress(page), erased, LOG_PAGE_HEADER_SIZE);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+  }
+  m_started = false;
+  m_head_page = 0;
+  m_head_offset = LOG_PAGE_HEADER_SIZE;
+  m_last_offset = 0;
+  m_head_sequence = 0;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Checks whether the log holds no records.
+ *
+ * @return true if no record has been appended.
+ */
+bool Mem24CSM01Log::isEmpty()
+{
+  return (!m_started);
+}
+
+/**
+ * @brief Returns the memory address of a page of the ring.
+ *
+ * @param page The index of the page in the ring.
+ * @return uint32_t The address of the first byte of the page.
+ */
+uint32_t Mem24CSM01Log::pageAddress(uint16_t page)
+{
+  return ((uint32_t)(m_first_page + page) * MAX_MEMORY_PAGE_SIZE);
+}
+
+/**
+ * @brief Reads the sequence number of a page.
+ *
+ * @param page The index of the page in the ring.
+ * @param sequence Pointer where the sequence number is stored, LOG_ERASED_SEQUENCE for an unused page.
+ * @return MEMORYRESULT The result of the read.
+ */
+MEMORYRESULT Mem24CSM01Log::readSequence(uint16_t page, uint32_t *sequence)
+{
+  uint8_t header[LOG_PAGE_HEADER_SIZE];
+  MEMORYRESULT result = m_memory->read(pageAddress(page), header, LOG_PAGE_HEADER_SIZE);
+  *sequence = (uint32_t)header[0] | ((uint32_t)header[1] << 8) | ((uint32_t)header[2] << 16) | ((uint32_t)header[3] << 24);
+  return (result);
+}
+
+/**
+ * @brief Finds the newest record and the free space of the head page walking its records.
+ *
+ * The page is read in windows of LOG_SCAN_WINDOW_SIZE bytes and every record header found
+ * in the window is parsed without reading the memory again, a new window is read only
+ * when the next header is outside the current one.
+ *
+ * @param page The index of the page in the ring.
+ * @param sequence The sequence number of the page.
+ * @return MEMORYRESULT The result of the reads.
+ */
+MEMORYRESULT Mem24CSM01Log::findPageEnd(uint16_t page, uint32_t sequence)
+{
+  uint8_t window[LOG_SCAN_WINDOW_SIZE];
+  uint16_t windowStart = 0;
+  uint16_t windowSize = 0;
+  uint16_t offset = LOG_PAGE_HEADER_SIZE;
+  m_last_offset = 0;
+  while (offset + LOG_RECORD_HEADER_SIZE < MAX_MEMORY_PAGE_SIZE)
+  {
+    if (offset < windowStart || offset + LOG_RECORD_HEADER_SIZE > windowStart + windowSize) // Header outside the window
+    {
+      windowStart = offset;
+      windowSize = MAX_MEMORY_PAGE_SIZE - offset;
+      if (windowSize > LOG_SCAN_WINDOW_SIZE)
+      {
+        windowSize = LOG_SCAN_WINDOW_SIZE;
+      }
+      MEMORYRESULT result = m_memory->read(pageAddress(page) + windowStart, window, windowSize);
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+    }
+    const uint8_t *header = window + (offset - windowStart);
+    if (!isRecordValid(header, sequence, offset))
+    {
+      break;
+    }
+    m_last_offset = offset;
+    offset += LOG_RECORD_HEADER_SIZE + header[0];
+  }
+  m_head_offset = offset;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Finds the newest record and the free space of the head page for fixed size records.
+ *
+ * Fixed size records are stored in slots at known offsets and the slots are filled in
+ * order, so the first free slot is found with a binary search over the slot headers.
+ *
+ * @param page The index of the page in the ring.
+ * @param sequence The sequence number of the page.
+ * @return MEMORYRESULT The result of the reads.
+ */
+MEMORYRESULT Mem24CSM01Log::findSlotEnd(uint16_t page, uint32_t sequence)
+{
+  uint16_t slotSize = LOG_RECORD_HEADER_SIZE + m_record_size;
+  uint16_t low = 0;                                                         // Slots known to be used
+  uint16_t high = (MAX_MEMORY_PAGE_SIZE - LOG_PAGE_HEADER_SIZE) / slotSize; // Slots of the page
+  while (low < high)
+  {
+    uint16_t middle = low + (high - low) / 2;
+    uint16_t offset = LOG_PAGE_HEADER_SIZE + middle * slotSize;
+    uint8_t header[LOG_RECORD_HEADER_SIZE];
+    MEMORYRESULT result = m_memory->read(pageAddress(page) + offset, header, LOG_RECORD_HEADER_SIZE);
+    if (result != MEMORYRESULT::OK)
+    {
+      return (result);
+    }
+    if (isRecordValid(header, sequence, offset))
+    {
+      low = middle + 1;
+    }
+    else
+    {
+      high = middle;
+    }
+  }
+  m_head_offset = LOG_PAGE_HEADER_SIZE + low * slotSize;
+  m_last_offset = low > 0 ? m_head_offset - slotSize : 0;
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Checks whether a record header belongs to the page being read.
+ *
+ * The tag holds the low 16 bits of the page sequence number, records left from the
+ * previous laps of the ring have a different tag.
+ *
+ * @param header The record header.
+ * @param sequence The sequence number of the page.
+ * @param offset The offset of the record in the page.
+ * @return true if the record is valid.
+ */
+bool Mem24CSM01Log::isRecordValid(const uint8_t *header, uint32_t sequence, uint16_t offset)
+{
+  uint8_t size = header[0];
+  if (size == LOG_END_OF_PAGE || size > LOG_MAX_RECORD_SIZE || (m_record_size != 0 && size != m_record_size))
+  {
+    return (false);
+  }
+  if (offset + LOG_RECORD_HEADER_SIZE + size > MAX_MEMORY_PAGE_SIZE)
+  {
+    return (false);
+  }
+  return (header[1] == (sequence & 0xFF) && header[2] == ((sequence >> 8) & 0xFF));
+}
@@ -0,0 +1,71 @@
+/*
+  Mem24CSM01Log - Wear-leveled circular log on the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Log_h
+#define MIC24CSM01Log_h
+
+#include "MIC24CSM01.h"
+
+// Page layout: 4 bytes sequence number, then the records
+// Record layout: 1 byte length, 2 bytes tag (low 16 bits of the page sequence number), payload
+#define LOG_PAGE_HEADER_SIZE 4
+#define LOG_RECORD_HEADER_SIZE 3
+#define LOG_MAX_RECORD_SIZE (MAX_MEMORY_PAGE_SIZE - LOG_PAGE_HEADER_SIZE - LOG_RECORD_HEADER_SIZE) // Largest payload of a record
+#define LOG_ERASED_SEQUENCE 0xFFFFFFFF // Sequence number read from a page never used by the log
+#define LOG_END_OF_PAGE 0x00           // Length byte written after the last record of a page
+#define LOG_SCAN_WINDOW_SIZE 32        // Bytes read at once while walking the records of a page
+#define LOG_MIN_PAGE_COUNT 2           // The head page is rewritten while the previous page keeps the older records
+
+/**
+ * @struct LogCursor
+ * @brief Position of a record in a Mem24CSM01Log, used to iterate over the records.
+ *
+ * @var LogCursor::page
+ * Index of the page in the log ring.
+ *
+ * @var LogCursor::offset
+ * Offset of the record inside the page.
+ *
+ * @var LogCursor::sequence
+ * Sequence number of the page.
+ */
+typedef struct
+{
+  uint16_t page;
+  uint16_t offset;
+  uint32_t sequence;
+} LogCursor;
+
+class Mem24CSM01Log
+{
+public:
+  Mem24CSM01Log(Mem24CSM01 &memory, uint16_t firstPage, uint16_t pageCount, uint8_t recordSize = 0);
+  MEMORYRESULT begin();
+  MEMORYRESULT append(const uint8_t *record, size_t size);
+  MEMORYRESULT rewind(LogCursor *cursor);
+  MEMORYRESULT next(LogCursor *cursor, uint8_t *buffer, size_t bufferSize, size_t *recordSize);
+  MEMORYRESULT latest(uint8_t *buffer, size_t bufferSize, size_t *recordSize);
+  MEMORYRESULT clear();
+  bool isEmpty();
+
+private:
+  uint32_t pageAddress(uint16_t page);
+  MEMORYRESULT readSequence(uint16_t page, uint32_t *sequence);
+  MEMORYRESULT findPageEnd(uint16_t page, uint32_t sequence);
+  MEMORYRESULT findSlotEnd(uint16_t page, uint32_t sequence);
+  bool isRecordValid(const uint8_t *header, uint32_t sequence, uint16_t offset);
+  Mem24CSM01 *m_memory;     // Memory chip holding the log
+  uint16_t m_first_page;    // First page of the log ring
+  uint16_t m_page_count;    // Number of pages of the log ring
+  uint8_t m_record_size;    // Size of every record, 0 for variable size records
+  bool m_started;           // true when at least one page has been written
+  uint16_t m_head_page;     // Page being filled
+  uint16_t m_head_offset;   // Offset of the first free byte in the head page
+  uint16_t m_last_offset;   // Offset of the newest record in the head page, 0 if the page holds no record
+  uint32_t m_head_sequence; // Sequence number of the head page
+};
+
+#endif
@@ -0,0 +1,240 @@
+#include "MIC24CSM01Rtos.h"
+
+#ifdef MEM24CSM01_ENABLE_RTOS
+
+/**
+ * @brief Constructor for the Mem24CSM01Rtos class.
+ *
+ * Several tasks can share the memory with the bus lock of Mem24CSM01 (MEM24CSM01_ENABLE_RTOS),
+ * each operation holding the bus from the address phase to the last byte. This class adds a
+ * single writer task: write() copies the bytes in a queue and returns, the writer task writes
+ * them one request at a time and releases the bus between two requests, so the reads of the
+ * other tasks run between the page writes instead of waiting for the whole block.
+ * The reads do not see the queued writes until they have been written, call flush() first
+ * when the data just written must be read back.
+ *
+ * @param memory The memory chip, begin() must have been called.
+ */
+Mem24CSM01Rtos::Mem24CSM01Rtos(Mem24CSM01 &memory)
+{
+  m_memory = &memory;
+  m_queue = nullptr;
+  m_task = nullptr;
+  m_error_lock = nullptr;
+  m_last_error = MEMORYRESULT::OK;
+}
+
+/**
+ * @brief Creates the request queue and starts the writer task.
+ *
+ * @param stackSize The stack size of the writer task.
+ * @param priority The priority of the writer task.
+ * @return true if the writer task is running, false if the queue, its lock or the task could not be created.
+ */
+bool Mem24CSM01Rtos::begin(uint32_t stackSize, UBaseType_t priority)
+{
+  if (m_task != nullptr)
+  {
+    return (true);
+  }
+  m_error_lock = xSemaphoreCreateMutex();
+  if (m_error_lock == nullptr)
+  {
+    return (false);
+  }
+  m_queue = xQueueCreate(MEM24CSM01_RTOS_QUEUE_LENGTH, sizeof(RtosWriteRequest));
+  if (m_queue == nullptr)
+  {
+    vSemaphoreDelete(m_error_lock);
+    m_error_lock = nullptr;
+    return (false);
+  }
+  if (xTaskCreate(writerTask, "mem24csm01", stackSize, this, priority, &m_task) != pdPASS)
+  {
+    vQueueDelete(m_queue);
+    vSemaphoreDelete(m_error_lock);
+    m_error_lock = nullptr;
+    m_queue = nullptr;
+    m_task = nullptr;
+    return (false);
+  }
+  return (true);
+}
+
+/**
+ * @brief Queues a block for the writer task.
+ *
+ * The block is copied, the buffer can be reused when the function returns. Blocks larger
+ * than MEM24CSM01_RTOS_WRITE_SIZE take several queue entries, with a full queue the call
+ * waits up to wait ticks for each entry. The result of the write itself is reported by
+ * flush() and getLastError().
+ *
+ * @param address The address of the first byte.
+ * @param data The bytes to write.
+ * @param size The number of bytes.
+ * @return MEMORYRESULT OK when the whole block is queued, TIMEOUT when the queue stayed full (the
+ * bytes before have been queued), ADDRESS_EXCEEDS_LIMIT or BUFFER_TOO_LARGE if the block is out of
+ * the memory, GENERIC_ERROR if begin() has not been called.
+ */
+MEMORYRESULT Mem24CSM01Rtos::write(uint32_t address, const uint8_t *data, size_t size, TickType_t wait)
+{
+  if (m_queue == nullptr)
+  {
+    return (MEMORYRESULT::GENERIC_ERROR);
+  }
+  if (address > MAX_MEMORY_ADDRESS_VALUE)
+  {
+    return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+  }
+  if (size > MEMORY_SIZE - address)
+  {
+    return (MEMORYRESULT::BUFFER_TOO_LARGE);
+  }
+  RtosWriteRequest request;
+  request.notify = nullptr;
+  while (size > 0)
+  {
+    // Cut the requests on the page boundaries, with the default entry size a request is then a single write transaction
+    size_t chunk = MAX_MEMORY_PAGE_SIZE - (address % MAX_MEMORY_PAGE_SIZE);
+    if (chunk > size)
+    {
+      chunk = size;
+    }
+    if (chunk > MEM24CSM01_RTOS_WRITE_SIZE)
+    {
+      chunk = MEM24CSM01_RTOS_WRITE_SIZE;
+    }
+    request.address = address;
+    request.size = (uint16_t)chunk;
+    memcpy(request.data, data, chunk);
+    if (xQueueSend(m_queue, &request, wait) != pdTRUE)
+    {
+      return (MEMORYRESULT::TIMEOUT);
+    }
+    address += chunk;
+    data += chunk;
+    size -= chunk;
+  }
+  return (MEMORYRESULT::OK);
+}
+
+/**
+ * @brief Reads a block in the calling task.
+ *
+ * The read holds the bus lock only for itself and runs between two writes of the writer task.
+ * The writes still in the queue are not visible, call flush() before to read them back.
+ *
+ * @param address The address of the first byte.
+ * @param data The buffer receiving the bytes.
+ * @param size The number of bytes.
+ * @return MEMORYRESULT The result of Mem24CSM01::read().
+ */
+MEMORYRESULT Mem24CSM01Rtos::read(uint32_t address, uint8_t *data, size_t size)
+{
+  return (m_memory->read(address, data, size));
+}
+
+/**
+ * @brief Waits until the writes queued before the call are written.
+ *
+ * @param wait The maximum number of ticks to wait.
+ * @return MEMORYRESULT The first error of the writer task since the last flush(), OK if every
+ * write succeeded, TIMEOUT if the writes are still running after wait ticks.
+ */
+MEMORYRESULT Mem24CSM01Rtos::flush(TickType_t wait)
+{
+  if (m_queue == nullptr)
+  {
+    return (MEMORYRESULT::GENERIC_ERROR);
+  }
+  RtosWriteRequest marker;
+  marker.address = 0;
+  marker.size = 0;
+  marker.notify = xTaskGetCurrentTaskHandle();
+  ulTaskNotifyTake(pdTRUE, 0); // Drop a notification left by a flush() which timed out
+  if (xQueueSend(m_queue, &marker, wait) != pdTRUE || ulTaskNotifyTake(pdTRUE, wait) == 0)
+  {
+    return (MEMORYRESULT::TIMEOUT);
+  }
+  return (takeLastError(true));
+}
+
+/**
+ * @brief Returns the first error of the writer task since the last flush().
+ *
+ * @return MEMORYRESULT OK if every write succeeded.
+ */
+MEMORYRESULT Mem24CSM01Rtos::getLastError()
+{
+  if (m_error_lock == nullptr)
+  {
+    return (m_last_error);
+  }
+  return (takeLastError(false));
+}
+
+/**
+ * @brief Reads the first error of the writer task under the error lock.
+ *
+ * @param clear true to reset the error to OK.
+ * @return MEMORYRESULT The error, OK if every write succeeded.
+ */
+MEMORYRESULT Mem24CSM01Rtos::takeLastError(bool clear)
+{
+  xSemaphoreTake(m_error_lock, portMAX_DELAY);
+  MEMORYRESULT result = m_last_error;
+  if (clear)
+  {
+    m_last_error = MEMORYRESULT::OK;
+  }
+  xSemaphoreGive(m_error_lock);
+  return (result);
+}
+
+/**
+ * @brief Records a failure of the writer task under the error lock, only the first one is kept.
+ *
+ * @param result The result of the failed write.
+ */
+void Mem24CSM01Rtos::recordError(MEMORYRESULT result)
+{
+  xSemaphoreTake(m_error_lock, portMAX_DELAY);
+  if (m_last_error == MEMORYRESULT::OK)
+  {
+    m_last_error = result;
+  }
+  xSemaphoreGive(m_error_lock);
+}
+
+/**
+ * @brief Writer task, writes the queued requests in order.
+ *
+ * Each request is written with the bus lock held for its write transaction only, the write
+ * cycle ends while the other tasks can read (their ACK polling waits for the chip).
+ *
+ * @param parameter The Mem24CSM01Rtos instance.
+ */
+void Mem24CSM01Rtos::writerTask(void *parameter)
+{
+  Mem24CSM01Rtos *self = static_cast<Mem24CSM01Rtos *>(parameter);
+  RtosWriteRequest request;
+  for (;;)
+  {
+    if (xQueueReceive(self->m_queue, &request, portMAX_DELAY) != pdTRUE)
+    {
+      continue;
+    }
+    if (request.notify != nullptr)
+    {
+      xTaskNotifyGive(request.notify);
+      continue;
+    }
+    MEMORYRESULT result = self->m_memory->writeBulk(request.address, request.data, request.size);
+    if (result != MEMORYRESULT::OK)
+    {
+      self->recordError(result);
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,67 @@
+/*
+  Mem24CSM01Rtos - FreeRTOS writer task for the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Rtos_h
+#define MIC24CSM01Rtos_h
+
+#include "MIC24CSM01.h"
+
+#ifdef MEM24CSM01_ENABLE_RTOS
+
+#if defined(__has_include) && __has_include(<freertos/queue.h>)
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#else
+#include <task.h>
+#include <queue.h>
+#endif
+
+// Bytes copied in a queued write request, larger writes are split over several requests.
+// The default is the largest single write transaction, a full page where the Wire buffer allows it
+#ifndef MEM24CSM01_RTOS_WRITE_SIZE
+#define MEM24CSM01_RTOS_WRITE_SIZE MEM24CSM01_WRITE_CHUNK_SIZE
+#endif
+
+// Write requests waiting for the writer task
+#ifndef MEM24CSM01_RTOS_QUEUE_LENGTH
+#define MEM24CSM01_RTOS_QUEUE_LENGTH 8
+#endif
+
+#define MEM24CSM01_RTOS_STACK_SIZE 3072 // Writer task stack, in words on most ports and in bytes on ESP32
+#define MEM24CSM01_RTOS_PRIORITY 1      // Writer task priority
+
+typedef struct
+{
+  uint32_t address;                         // First address to write
+  TaskHandle_t notify;                      // Task waiting in flush(), nullptr for a write request
+  uint16_t size;                            // Bytes used in data
+  uint8_t data[MEM24CSM01_RTOS_WRITE_SIZE]; // Copy of the bytes to write
+} RtosWriteRequest;
+
+class Mem24CSM01Rtos
+{
+public:
+  Mem24CSM01Rtos(Mem24CSM01 &memory);
+  bool begin(uint32_t stackSize = MEM24CSM01_RTOS_STACK_SIZE, UBaseType_t priority = MEM24CSM01_RTOS_PRIORITY);
+  MEMORYRESULT write(uint32_t address, const uint8_t *data, size_t size, TickType_t wait = portMAX_DELAY);
+  MEMORYRESULT read(uint32_t address, uint8_t *data, size_t size);
+  MEMORYRESULT flush(TickType_t wait = portMAX_DELAY);
+  MEMORYRESULT getLastError();
+
+private:
+  static void writerTask(void *parameter);
+  MEMORYRESULT takeLastError(bool clear);
+  void recordError(MEMORYRESULT result);
+  Mem24CSM01 *m_memory;           // Memory chip
+  QueueHandle_t m_queue;          // Write requests for the writer task
+  TaskHandle_t m_task;            // Writer task
+  SemaphoreHandle_t m_error_lock; // Guards m_last_error, written by the writer task and read by the callers
+  MEMORYRESULT m_last_error;      // First failure of the writer task since the last flush(), OK when every write succeeded
+};
+
+#endif
+
+#endif
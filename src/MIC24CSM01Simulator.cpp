@@ -0,0 +1,406 @@
+#include "MIC24CSM01Simulator.h"
+
+#if !defined(ARDUINO_ARCH_AVR)
+
+/**
+ * @brief Constructor for the Mem24CSM01Simulator class.
+ *
+ * The memory array starts erased, the configuration register cleared and the serial number
+ * set to 0, 1, 2 ... 15.
+ *
+ * @param A1 The A1 address pin of the simulated chip.
+ * @param A2 The A2 address pin of the simulated chip.
+ * @param bufferSize The size of the transmit and receive buffers, the Wire buffer of the board by default.
+ */
+Mem24CSM01Simulator::Mem24CSM01Simulator(bool A1, bool A2, size_t bufferSize)
+{
+  memset(m_memory, ERASED_VALUE, sizeof(m_memory));
+  memset(m_security, ERASED_VALUE, sizeof(m_security));
+  for (uint8_t i = 0; i < SERIAL_NUMBER_BYTE_SIZE; ++i)
+  {
+    m_security[i] = i;
+  }
+  memset(m_ecc_pages, 0, sizeof(m_ecc_pages));
+  m_config = 0;
+  m_memory_address = BASE_MEMREG_ADDR | (A2 << 2) | (A1 << 1);
+  m_register_address = BASE_CFGREG_ADDR | (A2 << 2) | (A1 << 1);
+  m_buffer_size = bufferSize > sizeof(m_tx) ? sizeof(m_tx) : bufferSize; // Larger buffers are never filled by the driver
+  m_tx_address = 0;
+  m_tx_length = 0;
+  m_rx_length = 0;
+  m_rx_position = 0;
+  m_pointer = 0;
+  m_register_selected = 0;
+  m_security_pointer = 0;
+  m_manufacturer_pending = false;
+  m_clock = MEM24CSM01_CLOCK_STANDARD;
+  m_write_cycle_ns = (uint32_t)WRITE_CYCLE_TIME * 1000000;
+  m_now_ns = 0;
+  m_busy_until_ns = 0;
+  resetCounters();
+}
+
+void Mem24CSM01Simulator::begin()
+{
+  m_clock = MEM24CSM01_CLOCK_STANDARD;
+}
+
+void Mem24CSM01Simulator::end()
+{
+}
+
+void Mem24CSM01Simulator::setClock(uint32_t clock)
+{
+  m_clock = clock == 0 ? MEM24CSM01_CLOCK_STANDARD : clock;
+}
+
+void Mem24CSM01Simulator::beginTransmission(uint8_t deviceAddress)
+{
+  m_tx_address = deviceAddress;
+  m_tx_length = 0;
+}
+
+size_t Mem24CSM01Simulator::write(uint8_t value)
+{
+  if (m_tx_length >= m_buffer_size)
+  {
+    return (0); // Like Wire, the byte is dropped when the buffer is full
+  }
+  m_tx[m_tx_length++] = value;
+  return (1);
+}
+
+size_t Mem24CSM01Simulator::write(const uint8_t *data, size_t size)
+{
+  size_t written = 0;
+  while (written < size && write(data[written]) == 1)
+  {
+    written++;
+  }
+  return (written);
+}
+
+/**
+ * @brief Returns the virtual time in microseconds.
+ *
+ * @return unsigned long The time elapsed on the virtual clock, it wraps around like micros().
+ */
+unsigned long Mem24CSM01Simulator::getMicros()
+{
+  return ((unsigned long)(m_now_ns / 1000));
+}
+
+/**
+ * @brief Returns the virtual time in milliseconds.
+ *
+ * @return unsigned long The time elapsed on the virtual clock, it wraps around like millis().
+ */
+unsigned long Mem24CSM01Simulator::getMillis()
+{
+  return ((unsigned long)(m_now_ns / 1000000));
+}
+
+/**
+ * @brief Advances the virtual clock instead of waiting.
+ *
+ * @param duration The time to wait in microseconds.
+ */
+void Mem24CSM01Simulator::delayMicros(uint32_t duration)
+{
+  m_now_ns += (uint64_t)duration * 1000;
+}
+
+/**
+ * @brief Sends the transmission to the simulated chip.
+ *
+ * @param sendStop Not used, the chip behaves the same way after a stop or a repeated start.
+ * @return uint8_t 0 on success, 2 when the device address is not acknowledged (other address or
+ *         write cycle in progress), 3 when the data is not acknowledged (protected or locked).
+ */
+uint8_t Mem24CSM01Simulator::endTransmission(bool sendStop)
+{
+  (void)sendStop;
+  advance(m_tx_length + 1);
+  if (m_tx_address == FIRST_RESERVED_HOST_CODE)
+  {
+    m_manufacturer_pending = m_tx_length == 1 && (m_tx[0] >> 1) == m_memory_address;
+    return (m_manufacturer_pending ? 0 : 3);
+  }
+  if (isBusy())
+  {
+    return (2);
+  }
+  if ((m_tx_address & 0x7E) == m_memory_address)
+  {
+    return (writeMemory());
+  }
+  if ((m_tx_address & 0x7E) == m_register_address)
+  {
+    return (writeRegister());
+  }
+  return (2);
+}
+
+/**
+ * @brief Reads bytes from the simulated chip into the receive buffer.
+ *
+ * @param deviceAddress The 7-bit device address.
+ * @param quantity The number of bytes wanted, limited to the receive buffer size.
+ * @return uint8_t The number of bytes received, 0 if the device address is not acknowledged.
+ */
+uint8_t Mem24CSM01Simulator::requestFrom(uint8_t deviceAddress, uint8_t quantity)
+{
+  m_rx_length = 0;
+  m_rx_position = 0;
+  if (quantity > m_buffer_size)
+  {
+    quantity = m_buffer_size;
+  }
+  advance(quantity + 1);
+  if (deviceAddress == SECOND_RESERVED_HOST_CODE && m_manufacturer_pending)
+  {
+    m_manufacturer_pending = false;
+    for (uint8_t i = 0; i < quantity && i < MANUFACTURER_REGISTER_BYTE_SIZE; ++i)
+    {
+      m_rx[m_rx_length++] = (SIMULATOR_MANUFACTURER >> (8 * (MANUFACTURER_REGISTER_BYTE_SIZE - 1 - i))) & 0xFF;
+    }
+    return (m_rx_length);
+  }
+  if (isBusy())
+  {
+    return (0);
+  }
+  if ((deviceAddress & 0x7E) == m_memory_address) // The A16 bit is taken from the address pointer
+  {
+    m_config &= ~(ECS_MASK); // The ECS bit reports the last read
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+      uint16_t page = m_pointer / MAX_MEMORY_PAGE_SIZE;
+      if (m_ecc_pages[page / 8] & (1 << (page % 8)))
+      {
+        m_config |= ECS_MASK;
+      }
+      m_rx[m_rx_length++] = m_memory[m_pointer];
+      m_pointer = (m_pointer + 1) & MAX_MEMORY_ADDRESS_VALUE; // Reads roll over the whole array
+    }
+    return (m_rx_length);
+  }
+  if ((deviceAddress & 0x7E) == m_register_address && m_register_selected == 1)
+  {
+    for (uint8_t i = 0; i < quantity && i < 2; ++i)
+    {
+      m_rx[m_rx_length++] = i == 0 ? m_config >> 8 : m_config & 0xFF;
+    }
+    return (m_rx_length);
+  }
+  if ((deviceAddress & 0x7E) == m_register_address && m_register_selected == 2)
+  {
+    for (uint8_t i = 0; i < quantity; ++i)
+    {
+      m_rx[m_rx_length++] = m_security[m_security_pointer];
+      m_security_pointer = (m_security_pointer + 1) % SIMULATOR_SECURITY_SIZE;
+    }
+    return (m_rx_length);
+  }
+  return (0);
+}
+
+int Mem24CSM01Simulator::read()
+{
+  return (m_rx_position < m_rx_length ? m_rx[m_rx_position++] : -1);
+}
+
+int Mem24CSM01Simulator::peek()
+{
+  return (m_rx_position < m_rx_length ? m_rx[m_rx_position] : -1);
+}
+
+/**
+ * @brief Returns the simulated memory array, to prepare or check its content without the bus.
+ *
+ * @return uint8_t* The MEMORY_SIZE bytes of the array.
+ */
+uint8_t *Mem24CSM01Simulator::getMemory()
+{
+  return (m_memory);
+}
+
+/**
+ * @brief Returns the simulated configuration register.
+ *
+ * @return uint16_t The register value.
+ */
+uint16_t Mem24CSM01Simulator::getConfigurationRegister()
+{
+  return (m_config);
+}
+
+/**
+ * @brief Sets the serial number returned by the security register.
+ *
+ * @param serialNumber The SERIAL_NUMBER_BYTE_SIZE bytes of the serial number.
+ */
+void Mem24CSM01Simulator::setSerialNumber(const uint8_t *serialNumber)
+{
+  memcpy(m_security, serialNumber, SERIAL_NUMBER_BYTE_SIZE);
+}
+
+/**
+ * @brief Sets the duration of the write cycles, WRITE_CYCLE_TIME milliseconds by default.
+ *
+ * @param micros The duration in microseconds of virtual time.
+ */
+void Mem24CSM01Simulator::setWriteCycleTime(uint32_t micros)
+{
+  m_write_cycle_ns = micros * 1000;
+}
+
+/**
+ * @brief Marks the page holding an address as needing the error correction.
+ *
+ * Every read touching the page then sets the ECS bit of the configuration register.
+ *
+ * @param address An address in the page.
+ */
+void Mem24CSM01Simulator::injectEccError(uint32_t address)
+{
+  uint16_t page = (address & MAX_MEMORY_ADDRESS_VALUE) / MAX_MEMORY_PAGE_SIZE;
+  m_ecc_pages[page / 8] |= 1 << (page % 8);
+}
+
+/**
+ * @brief Returns the virtual time elapsed since the construction.
+ *
+ * @return uint64_t The time in nanoseconds.
+ */
+uint64_t Mem24CSM01Simulator::getElapsedNanos()
+{
+  return (m_now_ns);
+}
+
+/**
+ * @brief Returns the number of transactions since resetCounters().
+ *
+ * @return uint32_t The transactions, write cycle polls included.
+ */
+uint32_t Mem24CSM01Simulator::getTransactions()
+{
+  return (m_transactions);
+}
+
+/**
+ * @brief Returns the number of bytes on the bus since resetCounters().
+ *
+ * @return uint32_t The bytes, device address and word address bytes included.
+ */
+uint32_t Mem24CSM01Simulator::getBytesTransferred()
+{
+  return (m_bytes);
+}
+
+/**
+ * @brief Returns the number of write cycles since resetCounters().
+ *
+ * @return uint32_t The write cycles of the memory array and of the configuration register.
+ */
+uint32_t Mem24CSM01Simulator::getWriteCycles()
+{
+  return (m_write_cycles);
+}
+
+void Mem24CSM01Simulator::resetCounters()
+{
+  m_transactions = 0;
+  m_bytes = 0;
+  m_write_cycles = 0;
+}
+
+/**
+ * @brief Advances the virtual clock by the duration of a transaction.
+ *
+ * @param bytes The bytes of the transaction, device address included.
+ */
+void Mem24CSM01Simulator::advance(size_t bytes)
+{
+  m_transactions++;
+  m_bytes += bytes;
+  m_now_ns += ((uint64_t)bytes * SIMULATOR_BYTE_BITS + SIMULATOR_FRAME_BITS) * 1000000000ULL / m_clock;
+}
+
+bool Mem24CSM01Simulator::isBusy()
+{
+  return (m_now_ns < m_busy_until_ns);
+}
+
+/**
+ * @brief Handles a transmission to the memory array: address pointer, then the page write.
+ *
+ * @return uint8_t The transmission result, see endTransmission().
+ */
+uint8_t Mem24CSM01Simulator::writeMemory()
+{
+  if (m_tx_length < 2)
+  {
+    return (0); // Acknowledge polling, the pointer is not changed
+  }
+  m_pointer = ((uint32_t)(m_tx_address & 1) << 16) | ((uint32_t)m_tx[0] << 8) | m_tx[1];
+  if (m_tx_length == 2)
+  {
+    return (0);
+  }
+  if ((m_config & EWPM_MASK) && (m_config & (1 << (m_pointer / ZONE_SIZE)))) // Protected zone
+  {
+    return (3);
+  }
+  for (size_t i = 2; i < m_tx_length; ++i)
+  {
+    m_memory[m_pointer] = m_tx[i];
+    m_pointer = (m_pointer & ~(uint32_t)(MAX_MEMORY_PAGE_SIZE - 1)) | ((m_pointer + 1) & (MAX_MEMORY_PAGE_SIZE - 1)); // Wrap inside the page
+  }
+  m_busy_until_ns = m_now_ns + m_write_cycle_ns;
+  m_write_cycles++;
+  return (0);
+}
+
+/**
+ * @brief Handles a transmission to the registers: selection, then the configuration register write.
+ *
+ * @return uint8_t The transmission result, see endTransmission().
+ */
+uint8_t Mem24CSM01Simulator::writeRegister()
+{
+  if (m_tx_length < 2)
+  {
+    return (m_tx_length == 0 ? 0 : 3);
+  }
+  if (m_tx[0] == CFGREG_WRD_ADDRH && m_tx[1] == CFGREG_WRD_ADDRL)
+  {
+    m_register_selected = 1;
+    if (m_tx_length == 2)
+    {
+      return (0);
+    }
+    if (m_tx_length != 5 || (m_config & LOCK_MASK)) // A locked register does not acknowledge the data
+    {
+      return (3);
+    }
+    uint16_t value = ((uint16_t)m_tx[2] << 8) | m_tx[3];
+    if (m_tx[4] != REGISTER_LOCKED)
+    {
+      value &= ~(LOCK_MASK); // The lock needs the confirmation byte
+    }
+    m_config = (m_config & ECS_MASK) | (value & CONFIG_VALUE_MASK);
+    m_busy_until_ns = m_now_ns + m_write_cycle_ns;
+    m_write_cycles++;
+    return (0);
+  }
+  if (m_tx[0] == SECREG_WRD_ADDRH)
+  {
+    m_register_selected = 2;
+    m_security_pointer = m_tx[1];
+    return (m_tx_length == 2 ? 0 : 3); // The serial number part is read only
+  }
+  return (3);
+}
+
+#endif
@@ -0,0 +1,99 @@
+/*
+  Mem24CSM01Simulator - Simulated 24CSM01 chip behind the Mem24CSM01Backend interface
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Simulator_h
+#define MIC24CSM01Simulator_h
+
+#include "MIC24CSM01.h"
+
+// The simulated memory array takes 128 KiB of RAM, more than any AVR board has
+#if !defined(ARDUINO_ARCH_AVR)
+
+#define SIMULATOR_SECURITY_SIZE 256       // Size of the security register, the serial number is in the first bytes
+#define SIMULATOR_MANUFACTURER 0x00D0D0   // Manufacturer register
+#define SIMULATOR_BYTE_BITS 9             // Bits on the bus for every byte, acknowledge included
+#define SIMULATOR_FRAME_BITS 2            // Start and stop conditions of a transaction
+#define SIMULATOR_PAGE_COUNT (MEMORY_SIZE / MAX_MEMORY_PAGE_SIZE)
+
+/**
+ * @class Mem24CSM01Simulator
+ * @brief Backend emulating the 24CSM01 in RAM with a virtual bus clock, no chip is needed.
+ *
+ * The simulator answers the same transactions as the chip: memory array with the address
+ * pointer wrapping inside the page on writes and over the whole array on reads, write cycle
+ * during which every transaction is not acknowledged, configuration register with the
+ * software write protection and the lock, security register and manufacturer register.
+ * The transmit and receive buffers have the size of the Wire buffer of the board, or the one
+ * given to the constructor, to reproduce the limits of small boards.
+ * The time is virtual: every byte advances the clock by 9 bit periods of the bus clock and
+ * a write cycle lasts the configured time measured on this clock, so the benchmarks report
+ * the bus time of the real chip whatever the speed of the board running them. The driver
+ * reads the time from the backend, so its timeouts and write cycle estimates run on the
+ * virtual clock too.
+ */
+class Mem24CSM01Simulator : public Mem24CSM01Backend
+{
+public:
+  Mem24CSM01Simulator(bool A1 = false, bool A2 = false, size_t bufferSize = MEM24CSM01_WIRE_BUFFER_SIZE);
+  void begin();
+  void end();
+  void setClock(uint32_t clock);
+  void beginTransmission(uint8_t deviceAddress);
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *data, size_t size);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t deviceAddress, uint8_t quantity);
+  int read();
+  int peek();
+  unsigned long getMicros();
+  unsigned long getMillis();
+  void delayMicros(uint32_t duration);
+
+  uint8_t *getMemory();
+  uint16_t getConfigurationRegister();
+  void setSerialNumber(const uint8_t *serialNumber);
+  void setWriteCycleTime(uint32_t micros);
+  void injectEccError(uint32_t address);
+  uint64_t getElapsedNanos();
+  uint32_t getTransactions();
+  uint32_t getBytesTransferred();
+  uint32_t getWriteCycles();
+  void resetCounters();
+
+private:
+  void advance(size_t bytes);
+  bool isBusy();
+  uint8_t writeMemory();
+  uint8_t writeRegister();
+  uint8_t m_memory[MEMORY_SIZE];                   // Memory array
+  uint8_t m_security[SIMULATOR_SECURITY_SIZE];     // Security register
+  uint8_t m_ecc_pages[SIMULATOR_PAGE_COUNT / 8];   // Pages whose reads set the ECS bit
+  uint16_t m_config;                               // Configuration register
+  uint8_t m_memory_address;                        // Device address of the memory array, A16 = 0
+  uint8_t m_register_address;                      // Device address of the registers
+  size_t m_buffer_size;                            // Size of the transmit and receive buffers
+  uint8_t m_tx_address;                            // Device address of the transmission being built
+  uint8_t m_tx[MAX_MEMORY_PAGE_SIZE + 3];          // Bytes of the transmission being built
+  size_t m_tx_length;                              // Bytes used in m_tx
+  uint8_t m_rx[MAX_MEMORY_PAGE_SIZE];              // Bytes received by the last requestFrom()
+  size_t m_rx_length;                              // Bytes used in m_rx
+  size_t m_rx_position;                            // Next byte returned by read()
+  uint32_t m_pointer;                              // Address pointer of the memory array
+  uint8_t m_register_selected;                     // Register addressed last, 0 none, 1 configuration, 2 security
+  uint16_t m_security_pointer;                     // Address pointer of the security register
+  bool m_manufacturer_pending;                     // True after the first reserved host code transaction
+  uint32_t m_clock;                                // Bus clock in Hz
+  uint32_t m_write_cycle_ns;                       // Duration of a write cycle
+  uint64_t m_now_ns;                               // Virtual time
+  uint64_t m_busy_until_ns;                        // End of the write cycle in progress
+  uint32_t m_transactions;                         // Transactions since resetCounters()
+  uint32_t m_bytes;                                // Bytes on the bus since resetCounters(), address bytes included
+  uint32_t m_write_cycles;                         // Write cycles since resetCounters()
+};
+
+#endif
+
+#endif
@@ -0,0 +1,239 @@
+#include "MIC24CSM01Stream.h"
+
+/**
+ * @brief Constructor for the Mem24CSM01Stream class.
+ *
+ * The stream reads and writes an address range of the memory with the Arduino Stream and
+ * Print interfaces, e.g. to send the memory content with Serial.write() or to store it
+ * from a network client. The reads take the bytes straight from the Wire receive buffer,
+ * filled with MEM24CSM01_READ_CHUNK_SIZE bytes at a time. The writes are collected in a
+ * buffer of MEM24CSM01_STREAM_STAGING_SIZE bytes written when it is full or at the end of
+ * a page, the blocks passed to write(buffer, size) are written directly from the caller buffer.
+ * Reading and writing use two separate positions, both moved by seek().
+ *
+ * @param memory The memory chip.
+ * @param startAddress The first address of the range.
+ * @param size The size of the range.
+ */
+Mem24CSM01Stream::Mem24CSM01Stream(Mem24CSM01 &memory, uint32_t startAddress, uint32_t size)
+{
+  m_memory = &memory;
+  m_start_address = startAddress;
+  m_size = size;
+  m_read_offset = 0;
+  m_write_offset = 0;
+  m_buffered = 0;
+  m_buffer_generation = 0;
+  m_staged = 0;
+  m_last_result = MEMORYRESULT::OK;
+}
+
+/**
+ * @brief Returns the number of bytes left to read.
+ *
+ * @return int The bytes between the read position and the end of the range, limited to 32767.
+ */
+int Mem24CSM01Stream::available()
+{
+  uint32_t left = m_size - m_read_offset;
+  return (left > 0x7FFF ? 0x7FFF : (int)left);
+}
+
+/**
+ * @brief Reads the next byte of the range.
+ *
+ * @return int The byte, -1 at the end of the range or if the read failed (see getLastResult()).
+ */
+int Mem24CSM01Stream::read()
+{
+  if (!fill())
+  {
+    return (-1);
+  }
+  m_buffered--;
+  m_read_offset++;
+  return (m_memory->readBuffered());
+}
+
+/**
+ * @brief Returns the next byte of the range without moving the read position.
+ *
+ * @return int The byte, -1 at the end of the range or if the read failed (see getLastResult()).
+ */
+int Mem24CSM01Stream::peek()
+{
+  if (!fill())
+  {
+    return (-1);
+  }
+  return (m_memory->peekBuffered());
+}
+
+/**
+ * @brief Writes a byte at the write position.
+ *
+ * @param value The byte.
+ * @return size_t 1 if the byte has been accepted, 0 at the end of the range or if a write failed.
+ */
+size_t Mem24CSM01Stream::write(uint8_t value)
+{
+  if (m_write_offset >= m_size)
+  {
+    return (0);
+  }
+  m_staging[m_staged++] = value;
+  m_write_offset++;
+  if (m_staged == MEM24CSM01_STREAM_STAGING_SIZE || (m_start_address + m_write_offset) % MAX_MEMORY_PAGE_SIZE == 0)
+  {
+    if (commit() != MEMORYRESULT::OK)
+    {
+      setWriteError();
+      return (0);
+    }
+  }
+  return (1);
+}
+
+/**
+ * @brief Writes a block at the write position.
+ *
+ * When nothing is staged, blocks of at least MEM24CSM01_STREAM_STAGING_SIZE bytes are
+ * written directly from the caller buffer with writeBulk().
+ *
+ * @param buffer Pointer to the data.
+ * @param size The number of bytes.
+ * @return size_t The number of bytes accepted, less than size at the end of the range or if a write failed.
+ */
+size_t Mem24CSM01Stream::write(const uint8_t *buffer, size_t size)
+{
+  size_t written = 0;
+  while (written < size && m_write_offset < m_size)
+  {
+    if (m_staged == 0 && size - written >= MEM24CSM01_STREAM_STAGING_SIZE)
+    {
+      size_t direct = size - written;
+      if (direct > m_size - m_write_offset)
+      {
+        direct = m_size - m_write_offset;
+      }
+      m_last_result = m_memory->writeBulk(m_start_address + m_write_offset, buffer + written, direct);
+      if (m_last_result != MEMORYRESULT::OK)
+      {
+        setWriteError();
+        break;
+      }
+      m_write_offset += direct;
+      written += direct;
+      continue;
+    }
+    if (write(buffer[written]) == 0)
+    {
+      break;
+    }
+    written++;
+  }
+  return (written);
+}
+
+/**
+ * @brief Writes the staged bytes and waits for the end of the write cycle.
+ */
+void Mem24CSM01Stream::flush()
+{
+  if (commit() == MEMORYRESULT::OK)
+  {
+    m_last_result = m_memory->waitForWriteCompletion();
+  }
+}
+
+/**
+ * @brief Moves the read and the write positions, the staged bytes are written first.
+ *
+ * @param offset The new position from the start of the range, limited to the size of the range.
+ */
+void Mem24CSM01Stream::seek(uint32_t offset)
+{
+  commit();
+  if (offset > m_size)
+  {
+    offset = m_size;
+  }
+  m_read_offset = offset;
+  m_write_offset = offset;
+  m_buffered = 0;
+}
+
+/**
+ * @brief Returns the read position.
+ *
+ * @return uint32_t The offset from the start of the range of the next byte read.
+ */
+uint32_t Mem24CSM01Stream::position()
+{
+  return (m_read_offset);
+}
+
+/**
+ * @brief Returns the number of bytes left to read, without the limit of available().
+ *
+ * @return uint32_t The bytes between the read position and the end of the range.
+ */
+uint32_t Mem24CSM01Stream::remaining()
+{
+  return (m_size - m_read_offset);
+}
+
+/**
+ * @brief Returns the result of the last memory operation.
+ *
+ * @return MEMORYRESULT The result, the Stream interface reports only -1 or 0 on failure.
+ */
+MEMORYRESULT Mem24CSM01Stream::getLastResult()
+{
+  return (m_last_result);
+}
+
+/**
+ * @brief Ensures the next byte to read is in the Wire receive buffer.
+ *
+ * The staged bytes are written first so the reads return them. The buffer is filled
+ * again when it is empty or when another transaction of the library on the same bus has
+ * reused it. Code using the Wire library directly between two reads makes the buffer
+ * stale without being noticed, call seek(position()) after it.
+ *
+ * @return true if a byte is available, false at the end of the range or if the read failed.
+ */
+bool Mem24CSM01Stream::fill()
+{
+  if (m_read_offset >= m_size)
+  {
+    return (false);
+  }
+  if (m_staged > 0 && commit() != MEMORYRESULT::OK)
+  {
+    return (false);
+  }
+  if (m_buffered > 0 && m_buffer_generation == m_memory->getTransactionCount())
+  {
+    return (true);
+  }
+  m_last_result = m_memory->requestSequential(m_start_address + m_read_offset, m_size - m_read_offset, &m_buffered);
+  m_buffer_generation = m_memory->getTransactionCount();
+  return (m_last_result == MEMORYRESULT::OK && m_buffered > 0);
+}
+
+/**
+ * @brief Writes the staged bytes, they never cross a page boundary.
+ *
+ * @return MEMORYRESULT The result of the write.
+ */
+MEMORYRESULT Mem24CSM01Stream::commit()
+{
+  if (m_staged == 0)
+  {
+    return (MEMORYRESULT::OK);
+  }
+  m_last_result = m_memory->writeBulk(m_start_address + m_write_offset - m_staged, m_staging, m_staged);
+  m_staged = 0;
+  return (m_last_result);
+}
@@ -0,0 +1,52 @@
+/*
+  Mem24CSM01Stream - Arduino Stream adapter over an address range of the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01Stream_h
+#define MIC24CSM01Stream_h
+
+#include "MIC24CSM01.h"
+
+// Size of the buffer collecting the bytes written before a page write, at most one write transaction
+#ifndef MEM24CSM01_STREAM_STAGING_SIZE
+#if MEM24CSM01_WRITE_CHUNK_SIZE > 64
+#define MEM24CSM01_STREAM_STAGING_SIZE 64
+#else
+#define MEM24CSM01_STREAM_STAGING_SIZE MEM24CSM01_WRITE_CHUNK_SIZE
+#endif
+#endif
+
+class Mem24CSM01Stream : public Stream
+{
+public:
+  Mem24CSM01Stream(Mem24CSM01 &memory, uint32_t startAddress = 0, uint32_t size = MEMORY_SIZE);
+  int available();
+  int read();
+  int peek();
+  size_t write(uint8_t value);
+  size_t write(const uint8_t *buffer, size_t size);
+  using Print::write;
+  void flush();
+  void seek(uint32_t offset);
+  uint32_t position();
+  uint32_t remaining();
+  MEMORYRESULT getLastResult();
+
+private:
+  bool fill();
+  MEMORYRESULT commit();
+  Mem24CSM01 *m_memory;                              // Memory chip
+  uint32_t m_start_address;                          // First address of the range
+  uint32_t m_size;                                   // Size of the range
+  uint32_t m_read_offset;                            // Offset of the next byte read
+  uint32_t m_write_offset;                           // Offset of the next byte written, staged bytes included
+  size_t m_buffered;                                 // Bytes left in the Wire receive buffer for this stream
+  uint32_t m_buffer_generation;                      // Transaction count when the Wire buffer was filled
+  uint8_t m_staging[MEM24CSM01_STREAM_STAGING_SIZE]; // Bytes written and not committed yet
+  uint8_t m_staged;                                  // Bytes used in m_staging
+  MEMORYRESULT m_last_result;                        // Result of the last memory operation
+};
+
+#endif
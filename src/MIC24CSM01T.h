@@ -0,0 +1,188 @@
+/*
+  Mem24CSM01T - Compile-time configured driver for the Mem24CSM01 EEPROM chip
+  Author: Ugo Silato
+  Licence: MIT
+*/
+
+#ifndef MIC24CSM01T_h
+#define MIC24CSM01T_h
+
+#include "MIC24CSM01.h"
+
+/**
+ * @class Mem24CSM01T
+ * @brief Driver with the address pins, the bus and the buffer sizes fixed at compile time.
+ *
+ * Every method is static and inline, the device addresses, the chunk sizes and the page
+ * boundaries are constants, so the class takes no SRAM and the calls with constant
+ * arguments fold the bounds checks away. The class has no state: a write returns as soon
+ * as the data has been sent, and every operation starts with an ACK poll (a single
+ * empty transaction when no write cycle is running). The register accesses, the
+ * asynchronous writes and the other features need the runtime class Mem24CSM01.
+ *
+ * @tparam A1 The A1 address pin level.
+ * @tparam A2 The A2 address pin level.
+ * @tparam TxBufSize The size of the Wire transmit and receive buffers.
+ * @tparam PageSize The size of a write page of the chip.
+ * @tparam Bus The I2C bus the chip is connected to.
+ */
+template <bool A1, bool A2, size_t TxBufSize = MEM24CSM01_WIRE_BUFFER_SIZE, uint16_t PageSize = MAX_MEMORY_PAGE_SIZE, TwoWire &Bus = Wire>
+class Mem24CSM01T
+{
+public:
+  static_assert(TxBufSize > 2, "The Wire buffer must hold the two address bytes and some data");
+  static_assert((PageSize & (PageSize - 1)) == 0 && PageSize <= MAX_MEMORY_PAGE_SIZE, "The page size must be a power of two up to 256");
+
+  // Initializes the bus, clock 0 keeps the Wire library default
+  static void begin(uint32_t clock = 0)
+  {
+    Bus.begin();
+    if (clock != 0)
+    {
+      Bus.setClock(clock);
+    }
+  }
+
+  // 7-bit device address of the memory array for an address
+  static constexpr uint8_t deviceAddress(uint32_t address)
+  {
+    return (BASE_MEMREG_ADDR | (A2 << 2) | (A1 << 1) | ((address >> 16) & 0x01)); // 0b1010 A2 A1 A16
+  }
+
+  // Maximum data bytes of a write transaction
+  static constexpr size_t writeChunkSize()
+  {
+    return (TxBufSize - 2 < PageSize ? TxBufSize - 2 : PageSize);
+  }
+
+  // Maximum bytes of a read transaction
+  static constexpr size_t readChunkSize()
+  {
+    return (TxBufSize < 255 ? TxBufSize : 255);
+  }
+
+  // Waits with ACK polling until the chip accepts commands
+  static MEMORYRESULT waitForWriteCompletion(uint16_t timeout = WRITE_CYCLE_TIMEOUT)
+  {
+    unsigned long start = millis();
+    while (true)
+    {
+      Mem24CSM01WireBackend::countWireTransaction();
+      Bus.beginTransmission(deviceAddress(0));
+      if (Bus.endTransmission() == 0)
+      {
+        return (MEMORYRESULT::OK);
+      }
+      if (millis() - start >= timeout)
+      {
+        return (MEMORYRESULT::TIMEOUT);
+      }
+    }
+  }
+
+  // Reads a block of any size, see Mem24CSM01::read()
+  static MEMORYRESULT read(uint32_t address, uint8_t *buffer, size_t size)
+  {
+    if (address > MAX_MEMORY_ADDRESS_VALUE)
+    {
+      return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+    }
+    if (size > MEMORY_SIZE - address)
+    {
+      return (MEMORYRESULT::BUFFER_TOO_LARGE);
+    }
+    MEMORYRESULT result = waitForWriteCompletion();
+    while (result == MEMORYRESULT::OK && size > 0)
+    {
+      size_t chunkSize = size < readChunkSize() ? size : readChunkSize();
+      size_t boundaryRemaining = 0x10000 - (address & 0xFFFF); // Bytes left before the A16 boundary
+      if (chunkSize > boundaryRemaining)
+      {
+        chunkSize = boundaryRemaining;
+      }
+      Mem24CSM01WireBackend::countWireTransaction();
+      Bus.beginTransmission(deviceAddress(address));
+      Bus.write((uint8_t)(address >> 8));
+      Bus.write((uint8_t)address);
+      result = transmissionToMemoryResult(Bus.endTransmission());
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      Mem24CSM01WireBackend::countWireTransaction();
+      if (Bus.requestFrom(deviceAddress(address), (uint8_t)chunkSize) != chunkSize)
+      {
+        return (MEMORYRESULT::GENERIC_ERROR);
+      }
+      for (size_t i = 0; i < chunkSize; ++i)
+      {
+        *buffer++ = Bus.read();
+      }
+      address += chunkSize;
+      size -= chunkSize;
+    }
+    return (result);
+  }
+
+  // Reads a single byte
+  static MEMORYRESULT read(uint32_t address, uint8_t *data)
+  {
+    return (read(address, data, 1));
+  }
+
+  // Writes a block of any size split on page boundaries, see Mem24CSM01::writeBulk()
+  static MEMORYRESULT write(uint32_t address, const uint8_t *data, size_t size)
+  {
+    if (address > MAX_MEMORY_ADDRESS_VALUE)
+    {
+      return (MEMORYRESULT::ADDRESS_EXCEEDS_LIMIT);
+    }
+    if (size > MEMORY_SIZE - address)
+    {
+      return (MEMORYRESULT::BUFFER_TOO_LARGE);
+    }
+    while (size > 0)
+    {
+      size_t chunkSize = PageSize - (address & (PageSize - 1)); // Bytes left before the next page boundary
+      if (chunkSize > writeChunkSize())
+      {
+        chunkSize = writeChunkSize();
+      }
+      if (chunkSize > size)
+      {
+        chunkSize = size;
+      }
+      MEMORYRESULT result = waitForWriteCompletion();
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      Mem24CSM01WireBackend::countWireTransaction();
+      Bus.beginTransmission(deviceAddress(address));
+      size_t queued = Bus.write((uint8_t)(address >> 8));
+      queued += Bus.write((uint8_t)address);
+      queued += Bus.write(data, chunkSize);
+      result = transmissionToMemoryResult(Bus.endTransmission());
+      if (result != MEMORYRESULT::OK)
+      {
+        return (result);
+      }
+      if (queued != chunkSize + 2)
+      {
+        return (MEMORYRESULT::WIRE_BUFFER_OVERFLOW);
+      }
+      address += chunkSize;
+      data += chunkSize;
+      size -= chunkSize;
+    }
+    return (MEMORYRESULT::OK);
+  }
+
+  // Writes a single byte
+  static MEMORYRESULT write(uint32_t address, uint8_t value)
+  {
+    return (write(address, &value, 1));
+  }
+};
+
+#endif